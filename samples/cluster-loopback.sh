@@ -0,0 +1,118 @@
+#!/bin/sh
+#
+# Local scale-out test - runs two instances sharing uplinks of loopback Mosquitto
+# broker, publishes uplinks of several nodes and checks, that every uplink was
+# journaled exactly once, by the instance owning its node.
+#
+# Requires mosquitto and mosquitto_pub (Mosquitto 1.6 or newer).
+#
+# usage: cluster-loopback.sh [path to ketcube-remote-terminal]
+#
+
+BIN=${1:-./ketcube-remote-terminal}
+PORT=${PORT:-18830}
+NODES="0000000000000001 0000000000000002 0000000000000003 0000000000000004 00000000000000a5 00000000000000b6 00000000000000c7 00000000000000d8"
+UPLINKS_PER_NODE=3
+
+WORK=$(mktemp -d)
+PIDS=""
+
+# prints index of instance owning given node - 32-bit FNV-1a of lowercase DevEUI modulo instance count,
+# the same as MQTT_Terminal::Get_Node_Owner
+node_owner() {
+	rest=$(printf '%s' "$1" | tr 'A-Z' 'a-z')
+	hash=2166136261
+
+	while [ -n "$rest" ]; do
+		char=${rest%"${rest#?}"}
+		rest=${rest#?}
+		hash=$(( ((hash ^ $(printf '%d' "'$char")) * 16777619) & 0xFFFFFFFF ))
+	done
+
+	echo $((hash % $2))
+}
+
+cleanup() {
+	kill $PIDS 2>/dev/null
+	rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+mosquitto -p "$PORT" >"$WORK/broker.log" 2>&1 &
+PIDS="$PIDS $!"
+sleep 1
+
+for i in 0 1; do
+	cat >"$WORK/instance$i.ini" <<CFG
+[mqtt]
+server = 127.0.0.1
+port = $PORT
+username = test
+password = test
+rx-topic = test/{deveui}/rx
+tx-topic = test/{deveui}/tx
+client-identifier = cluster-test-$i
+
+[cluster]
+share-group = ketcube-test
+instances = 2
+instance-index = $i
+
+[journal]
+file = $WORK/journal$i.bin
+sync-interval = 100
+CFG
+
+	"$BIN" -c "$WORK/instance$i.ini" --daemon "$WORK/control$i.sock" >"$WORK/instance$i.log" 2>&1 &
+	PIDS="$PIDS $!"
+done
+sleep 2
+
+for node in $NODES; do
+	for k in $(seq $UPLINKS_PER_NODE); do
+		# distinct frame counter, so the uplinks are not dropped as duplicates
+		mosquitto_pub -p "$PORT" -t "test/$node/rx" -m "{\"fPort\": 13, \"fCnt\": $k, \"data\": \"AAA=\"}"
+	done
+done
+sleep 2
+
+# daemons write their journals when stopped
+for pid in $PIDS; do
+	kill -TERM "$pid" 2>/dev/null
+done
+wait 2>/dev/null
+PIDS=""
+
+failed=0
+
+for i in 0 1; do
+	"$BIN" journal "$WORK/journal$i.bin" | grep ' RX ' | sed 's/.*node=\([0-9a-f]*\).*/\1/' >"$WORK/nodes$i.txt"
+	echo "instance $i: $(wc -l <"$WORK/nodes$i.txt") uplinks of $(sort -u "$WORK/nodes$i.txt" | wc -l) nodes"
+done
+
+for node in $NODES; do
+	count0=$(grep -c "^$node\$" "$WORK/nodes0.txt")
+	count1=$(grep -c "^$node\$" "$WORK/nodes1.txt")
+	owner=$(node_owner "$node" 2)
+
+	if [ "$owner" -eq 0 ]; then
+		owned=$count0
+	else
+		owned=$count1
+	fi
+
+	# all uplinks of the node have to reach one instance, the owner
+	if [ "$count0" -ne 0 ] && [ "$count1" -ne 0 ]; then
+		echo "FAIL: node $node journaled by both instances ($count0 + $count1)"
+		failed=1
+	elif [ "$owned" -ne $UPLINKS_PER_NODE ]; then
+		echo "FAIL: node $node has $owned of $UPLINKS_PER_NODE uplinks journaled by its owner, instance $owner"
+		failed=1
+	fi
+done
+
+if [ $failed -eq 0 ]; then
+	echo "OK"
+fi
+
+exit $failed
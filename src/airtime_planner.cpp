@@ -0,0 +1,212 @@
+/**
+ * @file    airtime_planner.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of airtime estimation of terminal requests and jobs
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <map>
+#include <algorithm>
+#include <cstring>
+
+#include "airtime_planner.h"
+
+Airtime_Estimate& Airtime_Estimate::operator+=(const Airtime_Estimate& other)
+{
+	downlinkBytes += other.downlinkBytes;
+	uplinkBytes += other.uplinkBytes;
+	downlinkMs += other.downlinkMs;
+	uplinkMs += other.uplinkMs;
+	frames += other.frames;
+
+	return *this;
+}
+
+Airtime_Estimate Airtime_Estimate::operator*(size_t count) const
+{
+	Airtime_Estimate result;
+
+	result.downlinkBytes = downlinkBytes * count;
+	result.uplinkBytes = uplinkBytes * count;
+	result.downlinkMs = downlinkMs * count;
+	result.uplinkMs = uplinkMs * count;
+	result.frames = frames * count;
+
+	return result;
+}
+
+Airtime_Planner::Airtime_Planner(const Terminal_Base& terminal, const Lora_Radio_Settings& radio, size_t maxPayload)
+	: mTerminal(terminal), mDownlinkRadio(radio), mUplinkRadio(radio), mMaxPayload(maxPayload)
+{
+	// uplinks carry payload CRC, downlinks do not
+	mDownlinkRadio.crc = false;
+	mUplinkRadio.crc = true;
+
+	if (mMaxPayload == 0) {
+		mMaxPayload = LoRaWAN_Max_Payload(radio);
+	}
+}
+
+size_t Airtime_Planner::Get_Max_Payload() const
+{
+	return mMaxPayload;
+}
+
+bool Airtime_Planner::Fits(size_t packetLen, size_t responseLen) const
+{
+	return (packetLen <= mMaxPayload) && (responseLen <= mMaxPayload);
+}
+
+Airtime_Estimate Airtime_Planner::Estimate(const std::vector<uint8_t>& packet, const std::vector<ketCube_terminal_cmd_t*>& commands) const
+{
+	Airtime_Estimate estimate;
+	ketCube_remoteTerminal_packet_header_t header;
+
+	estimate.frames = 1;
+	estimate.downlinkBytes = packet.size();
+	estimate.downlinkMs = LoRaWAN_Time_On_Air_Ms(mDownlinkRadio, packet.size());
+
+	if (packet.size() < sizeof(header) || commands.empty()) {
+		return estimate;
+	}
+
+	memcpy(&header, packet.data(), sizeof(header));
+
+	estimate.uplinkBytes = mTerminal.Get_Expected_Response_Size(static_cast<ketCube_terminal_command_opcode_t>(header.opcode), commands);
+	estimate.uplinkMs = LoRaWAN_Time_On_Air_Ms(mUplinkRadio, estimate.uplinkBytes);
+
+	return estimate;
+}
+
+Airtime_Estimate Airtime_Planner::Estimate(const Command_Request& request) const
+{
+	Airtime_Estimate estimate = Estimate(request.packet, request.commands);
+
+	if (!request.expectResponse) {
+		estimate.uplinkBytes = 0;
+		estimate.uplinkMs = 0;
+	}
+
+	return estimate;
+}
+
+void Airtime_Planner::Print_Estimate(const Airtime_Estimate& estimate, std::ostream& output) const
+{
+	output << "downlink " << estimate.downlinkBytes << " B / " << estimate.downlinkMs << " ms in " << estimate.frames << " frame(s), "
+		<< "response " << estimate.uplinkBytes << " B / " << estimate.uplinkMs << " ms";
+}
+
+void Airtime_Planner::Plan(const std::vector<Command_Request>& script, const std::vector<Fleet_Target>& targets, const Duty_Cycle_Settings& dutyCycle, std::ostream& output) const
+{
+	Airtime_Estimate job;
+	ketCube_remoteTerminal_packet_header_t header;
+
+	output << "Plan: SF" << mDownlinkRadio.spreadingFactor << "/" << mDownlinkRadio.bandwidthKhz << " kHz, CR 4/" << (4 + mDownlinkRadio.codingRate)
+		<< ", maximum payload " << mMaxPayload << " B" << std::endl;
+
+	for (size_t i = 0; i < script.size(); i++) {
+		const Command_Request& request = script[i];
+		const Airtime_Estimate estimate = Estimate(request);
+
+		output << "[" << (i + 1) << "] " << request.description << ": ";
+		Print_Estimate(estimate, output);
+		if (!Fits(estimate.downlinkBytes, estimate.uplinkBytes)) {
+			output << " - exceeds maximum payload!";
+		}
+		output << std::endl;
+
+		job += estimate;
+
+		if (request.packet.size() < sizeof(header) || request.commands.size() < 2) {
+			continue;
+		}
+
+		memcpy(&header, request.packet.data(), sizeof(header));
+
+		// every batch block is prepended by its length
+		size_t pos = sizeof(header);
+		for (ketCube_terminal_cmd_t* command : request.commands) {
+			const size_t blockLen = (pos < request.packet.size()) ? request.packet[pos] + 1 : 0;
+			const size_t respLen = mTerminal.Get_Expected_Response_Size(static_cast<ketCube_terminal_command_opcode_t>(header.opcode), { command }) - Terminal_Base::Response_Header_Length;
+
+			output << "    " << command->cmd << ": downlink " << blockLen << " B, response " << respLen << " B" << std::endl;
+
+			pos += blockLen;
+		}
+	}
+
+	output << "Job per node: ";
+	Print_Estimate(job, output);
+	output << std::endl;
+
+	const size_t nodeCount = std::max<size_t>(1, targets.size());
+	if (nodeCount > 1) {
+		output << "Job on " << nodeCount << " nodes: ";
+		Print_Estimate(job * nodeCount, output);
+		output << std::endl;
+	}
+
+	// the budget of one window is available at once, the rest is refilled with duty-cycle rate
+	double minDurationMs = 0;
+	auto budgetWait = [&](double airtimeMs, double percent) {
+		const double rate = percent / 100.0;
+		return std::max(0.0, airtimeMs - rate * dutyCycle.windowSecs * 1000.0) / rate;
+	};
+
+	if (dutyCycle.gatewayPercent > 0) {
+		std::map<std::string, size_t> gatewayNodes;
+		for (const Fleet_Target& target : targets) {
+			gatewayNodes[target.gateway]++;
+		}
+		if (gatewayNodes.empty()) {
+			gatewayNodes[""] = 1;
+		}
+
+		for (auto& gatewayPair : gatewayNodes) {
+			minDurationMs = std::max(minDurationMs, budgetWait(job.downlinkMs * gatewayPair.second, dutyCycle.gatewayPercent));
+		}
+	}
+
+	if (dutyCycle.nodePercent > 0) {
+		minDurationMs = std::max(minDurationMs, budgetWait(job.downlinkMs, dutyCycle.nodePercent));
+	}
+
+	output << "Round trips per node: " << script.size() << ", minimum duration imposed by duty cycle: " << (minDurationMs / 1000.0) << " s" << std::endl;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    airtime_planner.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains airtime estimation of terminal requests and jobs
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "terminal.h"
+#include "command_dispatcher.h"
+#include "duty_cycle_limiter.h"
+#include "fleet_runner.h"
+
+/*
+ * Estimated airtime of request and its response
+ */
+struct Airtime_Estimate
+{
+	size_t downlinkBytes = 0;			// application payload of downlink(s)
+	size_t uplinkBytes = 0;				// application payload of response(s)
+	double downlinkMs = 0;				// downlink time on air
+	double uplinkMs = 0;				// response time on air
+	size_t frames = 0;					// number of downlinks
+
+	Airtime_Estimate& operator+=(const Airtime_Estimate& other);
+	Airtime_Estimate operator*(size_t count) const;
+};
+
+/*
+ * Airtime planner - estimates airtime of requests from their serialized packets and expected response sizes
+ */
+class Airtime_Planner
+{
+	private:
+		// terminal used to resolve response sizes
+		const Terminal_Base& mTerminal;
+		// radio settings of downlinks
+		Lora_Radio_Settings mDownlinkRadio;
+		// radio settings of uplinks
+		Lora_Radio_Settings mUplinkRadio;
+		// maximum application payload length
+		size_t mMaxPayload;
+
+	protected:
+		// prints single estimate
+		void Print_Estimate(const Airtime_Estimate& estimate, std::ostream& output) const;
+
+	public:
+		// zero maximum payload means the one given by data rate
+		Airtime_Planner(const Terminal_Base& terminal, const Lora_Radio_Settings& radio, size_t maxPayload = 0);
+
+		// retrieves maximum application payload length
+		size_t Get_Max_Payload() const;
+		// checks, if the request and its response of given lengths fit in single frame
+		bool Fits(size_t packetLen, size_t responseLen) const;
+
+		// estimates airtime of serialized packet containing given commands
+		Airtime_Estimate Estimate(const std::vector<uint8_t>& packet, const std::vector<ketCube_terminal_cmd_t*>& commands) const;
+		// estimates airtime of request
+		Airtime_Estimate Estimate(const Command_Request& request) const;
+
+		// prints estimates of every request, command and the whole job on all targets, including the minimum duration imposed by duty cycle
+		void Plan(const std::vector<Command_Request>& script, const std::vector<Fleet_Target>& targets, const Duty_Cycle_Settings& dutyCycle, std::ostream& output) const;
+};
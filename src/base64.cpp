@@ -60,40 +60,40 @@ const char Base64::Encoding_Table[65] =
 	"abcdefghijklmnopqrstuvwxyz"
 	"0123456789+/";
 
-void Base64::Encode(std::string &ret, const uint8_t* buf, const size_t bufLen)
+size_t Base64::Encoded_Length(const size_t bufLen)
 {
-	size_t missing = 0;
-	size_t ret_size = bufLen;
-	while ((ret_size % 3) != 0) {
-		++ret_size;
-		++missing;
-	}
-
-	ret_size = 4 * ret_size / 3;
+	return 4 * ((bufLen + 2) / 3);
+}
 
-	ret.clear();
-	ret.reserve(ret_size);
+char* Base64::Encode_To(char* out, const uint8_t* buf, const size_t bufLen)
+{
+	const size_t groups = (bufLen + 2) / 3;
 
-	for (size_t i = 0; i < ret_size / 4; ++i) {
+	for (size_t i = 0; i < groups; ++i) {
 
+		// whole input group is read before writing output group; this makes in-place encoding possible
 		const size_t index = i * 3;
-		const uint8_t b3_0 = (index + 0 < bufLen) ? buf[index + 0] : 0;
+		const uint8_t b3_0 = buf[index + 0];
 		const uint8_t b3_1 = (index + 1 < bufLen) ? buf[index + 1] : 0;
 		const uint8_t b3_2 = (index + 2 < bufLen) ? buf[index + 2] : 0;
 
-		const uint8_t b4_0 = ((b3_0 & 0xfc) >> 2);
-		const uint8_t b4_1 = ((b3_0 & 0x03) << 4) + ((b3_1 & 0xf0) >> 4);
-		const uint8_t b4_2 = ((b3_1 & 0x0f) << 2) + ((b3_2 & 0xc0) >> 6);
-		const uint8_t b4_3 = ((b3_2 & 0x3f) << 0);
+		out[0] = Encoding_Table[((b3_0 & 0xfc) >> 2)];
+		out[1] = Encoding_Table[((b3_0 & 0x03) << 4) + ((b3_1 & 0xf0) >> 4)];
+		out[2] = (index + 1 < bufLen) ? Encoding_Table[((b3_1 & 0x0f) << 2) + ((b3_2 & 0xc0) >> 6)] : '=';
+		out[3] = (index + 2 < bufLen) ? Encoding_Table[((b3_2 & 0x3f) << 0)] : '=';
 
-		ret.push_back(Encoding_Table[b4_0]);
-		ret.push_back(Encoding_Table[b4_1]);
-		ret.push_back(Encoding_Table[b4_2]);
-		ret.push_back(Encoding_Table[b4_3]);
+		out += 4;
 	}
 
-	for (size_t i = 0; i != missing; ++i) {
-		ret[ret_size - i - 1] = '=';
+	return out;
+}
+
+void Base64::Encode(std::string &ret, const uint8_t* buf, const size_t bufLen)
+{
+	ret.resize(Encoded_Length(bufLen));
+
+	if (bufLen > 0) {
+		Encode_To(&ret[0], buf, bufLen);
 	}
 }
 
@@ -70,6 +70,12 @@ class Base64
 		// encodes "buf" byte buffer to base64 string "out"
 		static void Encode(std::string &out, const std::vector<uint8_t>& buf);
 
+		// retrieves exact length of base64 encoded buffer of given length
+		static size_t Encoded_Length(const size_t bufLen);
+		// encodes "buf" byte buffer to preallocated "out" of Encoded_Length(bufLen) chars; returns pointer past the last written char
+		// in-place encoding is supported, when the input is placed at the very end of the output area
+		static char* Encode_To(char* out, const uint8_t* buf, const size_t bufLen);
+
 		// decodes input "encoded_string" from base64 to byte buffer "out"
 		static void Decode(std::vector<uint8_t> &out, const std::string& encoded_string);
 };
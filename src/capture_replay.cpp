@@ -0,0 +1,183 @@
+/**
+ * @file    capture_replay.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains replay of captured MQTT traffic through the decoder implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+
+#include "capture_replay.h"
+#include "base64.h"
+#include "json11.hpp"
+
+Capture_Replayer::Capture_Replayer(MQTT_Terminal& terminal)
+	: mTerminal(terminal)
+{
+	//
+}
+
+int Capture_Replayer::Run(std::istream& capture, bool realtime, std::ostream& output)
+{
+	std::string line, topic, payload, err, respStr, node;
+	std::vector<uint8_t> frame;
+	// requests of nodes waiting for response; captures of several nodes interleave
+	std::map<std::string, Pending_Request> pending;
+	Pending_Request request;
+	bool result, responseOK, seqOK;
+	double firstTs = -1.0;
+
+	size_t lineNo = 0, downlinks = 0, uplinks = 0, decoded = 0, failures = 0, seqMismatches = 0, ignored = 0, unmatched = 0;
+
+	std::chrono::steady_clock::duration busyTime(0);
+	const auto replayStart = std::chrono::steady_clock::now();
+
+	while (std::getline(capture, line)) {
+		lineNo++;
+
+		const size_t tab1 = line.find('\t');
+		const size_t tab2 = (tab1 == std::string::npos) ? std::string::npos : line.find('\t', tab1 + 1);
+
+		if (tab2 == std::string::npos) {
+			if (!line.empty()) {
+				output << "line " << lineNo << ": malformed capture record" << std::endl;
+				failures++;
+			}
+			continue;
+		}
+
+		topic = line.substr(tab1 + 1, tab2 - tab1 - 1);
+		payload = line.substr(tab2 + 1);
+
+		// keep original spacing of records when asked to
+		if (realtime) {
+			const double ts = std::strtod(line.c_str(), nullptr);
+			if (firstTs < 0.0) {
+				firstTs = ts;
+			}
+			std::this_thread::sleep_until(replayStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(ts - firstTs)));
+		}
+
+		const auto recordStart = std::chrono::steady_clock::now();
+
+		if (mTerminal.Get_Tx_Node(topic, node)) {
+			// downlink - remember what was sent, so the response could be decoded
+			downlinks++;
+
+			json11::Json parsedMsg = json11::Json::parse(payload, err);
+			if (!err.empty() || !parsedMsg["data"].is_string()) {
+				output << "line " << lineNo << ": malformed downlink" << std::endl;
+				failures++;
+				continue;
+			}
+
+			Base64::Decode(frame, parsedMsg["data"].string_value());
+
+			if (!mTerminal.Decode_Request_Commands(frame, request.commands)) {
+				pending.erase(node);
+				output << "line " << lineNo << ": downlink does not contain valid request" << std::endl;
+				failures++;
+				continue;
+			}
+
+			memcpy(&request.header, frame.data(), sizeof(request.header));
+			pending[node] = request;
+		} else {
+			// uplink - push through the same path as the broker callback does
+			uplinks++;
+
+			if (!mTerminal.Incoming_Message(topic, std::move(payload))) {
+				output << "line " << lineNo << ": Incoming_Message failed" << std::endl;
+				failures++;
+				continue;
+			}
+
+			// messages for other ports are not queued at all
+			if (!mTerminal.Await_Message(node, frame, 1)) {
+				ignored++;
+				continue;
+			}
+
+			auto pitr = pending.find(node);
+			if (pitr == pending.end()) {
+				unmatched++;
+				continue;
+			}
+
+			const Pending_Request& nodeRequest = pitr->second;
+
+			if (nodeRequest.header.opcode == KETCUBE_TERMINAL_OPCODE_BATCH) {
+				result = mTerminal.Decode_Batch_Response(frame, nodeRequest.commands, Command_Schema::Built_In(), responseOK, respStr, nodeRequest.header.seq, seqOK);
+			} else {
+				result = mTerminal.Decode_Single_Response(frame, nodeRequest.commands, Command_Schema::Built_In(), responseOK, respStr, nodeRequest.header.seq, seqOK);
+			}
+
+			if (!seqOK) {
+				seqMismatches++;
+			} else if (!result) {
+				output << "line " << lineNo << ": decode failed: " << respStr << std::endl;
+				failures++;
+			} else {
+				decoded++;
+				pending.erase(pitr);
+			}
+		}
+
+		busyTime += std::chrono::steady_clock::now() - recordStart;
+	}
+
+	const double busySecs = std::chrono::duration<double>(busyTime).count();
+
+	output << "Replayed " << lineNo << " records: " << downlinks << " downlinks, " << uplinks << " uplinks" << std::endl;
+	output << "Decoded " << decoded << " responses, " << failures << " failures, " << seqMismatches << " sequence mismatches, "
+		<< ignored << " ignored, " << unmatched << " without pending request" << std::endl;
+	output << "Processing time " << (busySecs * 1000.0) << " ms";
+	if (busySecs > 0.0) {
+		output << " (" << static_cast<size_t>((downlinks + uplinks) / busySecs) << " records/s)";
+	}
+	output << std::endl;
+
+	return (failures == 0) ? 0 : 4;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file    capture_replay.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains replay of captured MQTT traffic through the decoder
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+
+#include "mqtt_terminal.h"
+
+/*
+ * Replays captured MQTT traffic through the receive path of terminal, without any broker
+ *
+ * Capture file consists of lines "<unix timestamp>\t<topic>\t<payload>"; downlinks (tx topic) set
+ * the pending commands of their node, uplinks (any other topic) are decoded against the pending commands of their node.
+ */
+class Capture_Replayer
+{
+	private:
+		/*
+		 * Request sent to node, waiting for response
+		 */
+		struct Pending_Request
+		{
+			// packet header; carries opcode and sequence number
+			ketCube_remoteTerminal_packet_header_t header;
+			// commands of request
+			std::vector<ketCube_terminal_cmd_t*> commands;
+		};
+
+		// terminal, that is never connected; recognizes downlinks by its TX topic
+		MQTT_Terminal& mTerminal;
+
+	public:
+		Capture_Replayer(MQTT_Terminal& terminal);
+
+		// replays the capture, either with original timing or as fast as possible; returns non-zero on decode failures
+		int Run(std::istream& capture, bool realtime, std::ostream& output);
+};
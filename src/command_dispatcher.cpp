@@ -0,0 +1,940 @@
+/**
+ * @file    command_dispatcher.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of asynchronous dispatcher of terminal commands
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+
+#include "command_dispatcher.h"
+#include "trace_recorder.h"
+
+// random device instance for generating initial SEQ's
+static std::random_device Random_Device;
+
+// how long to wait for incoming message when there is no deadline
+constexpr size_t Idle_Wait_Ms = 1000;
+
+const char* Command_Status_Name(Command_Status status)
+{
+	switch (status) {
+		case Command_Status::Pending:
+			return "pending";
+		case Command_Status::OK:
+			return "ok";
+		case Command_Status::Failed:
+			return "failed";
+		case Command_Status::Timeout:
+			return "timeout";
+		case Command_Status::Send_Failed:
+			return "send failed";
+		case Command_Status::Cancelled:
+			return "cancelled";
+	}
+
+	return "unknown";
+}
+
+const char* Command_Priority_Name(Command_Priority priority)
+{
+	switch (priority) {
+		case Command_Priority::Interactive:
+			return "interactive";
+		case Command_Priority::Normal:
+			return "normal";
+		case Command_Priority::Bulk:
+			return "bulk";
+	}
+
+	return "unknown";
+}
+
+bool Command_Priority_Parse(const std::string& name, Command_Priority& priority)
+{
+	for (size_t i = 0; i < Command_Priority_Count; i++) {
+		if (name == Command_Priority_Name(static_cast<Command_Priority>(i))) {
+			priority = static_cast<Command_Priority>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Command_Dispatcher::Command_Dispatcher(Terminal_Base& terminal, long responseTimeoutSecs)
+	: mTerminal(terminal), mLastTicket(0), mOutstanding(0), mInFlightCount(0), mRunning(false),
+	  mInitialRto(responseTimeoutSecs * 1000), mMinRto(responseTimeoutSecs * 1000), mMaxRto(responseTimeoutSecs * 1000), mPriorityAgingMs(0), mMaxRetransmissions(0),
+	  mMaxInFlight(0), mMaxInFlightPerGateway(0), mSchemas(nullptr), mStore(nullptr)
+{
+	//
+}
+
+Command_Dispatcher::~Command_Dispatcher()
+{
+	Stop();
+}
+
+void Command_Dispatcher::Set_Retransmission(long minResponseTimeoutSecs, long maxResponseTimeoutSecs, long maxRetransmissions)
+{
+	// initial timeout stays the same until the first round-trip is measured
+	mMinRto = minResponseTimeoutSecs * 1000;
+	mMaxRto = maxResponseTimeoutSecs * 1000;
+	mMaxRetransmissions = maxRetransmissions;
+}
+
+void Command_Dispatcher::Set_Concurrency(size_t maxInFlight, size_t maxInFlightPerGateway)
+{
+	mMaxInFlight = maxInFlight;
+	mMaxInFlightPerGateway = maxInFlightPerGateway;
+}
+
+void Command_Dispatcher::Set_Duty_Cycle(const Duty_Cycle_Settings& settings)
+{
+	mLimiter = Duty_Cycle_Limiter(settings);
+}
+
+std::vector<Duty_Cycle_Usage> Command_Dispatcher::Get_Duty_Cycle_Usage(bool includeNodes)
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	return mLimiter.Get_Usage(std::chrono::steady_clock::now(), includeNodes);
+}
+
+void Command_Dispatcher::Set_Schemas(Schema_Registry* registry)
+{
+	mSchemas = registry;
+}
+
+void Command_Dispatcher::Set_Node_Store(Node_Store* store, const std::string& defaultNode)
+{
+	mStore = store;
+	mDefaultNode = defaultNode;
+
+	// DevEUIs are compared in lowercase, as they appear in topics
+	std::transform(mDefaultNode.begin(), mDefaultNode.end(), mDefaultNode.begin(), ::tolower);
+}
+
+void Command_Dispatcher::Set_Priority_Aging(long agingSecs)
+{
+	mPriorityAgingMs = agingSecs * 1000;
+}
+
+std::vector<Command_Latency> Command_Dispatcher::Get_Latency()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	std::vector<Command_Latency> latency;
+
+	for (size_t i = 0; i < Command_Priority_Count; i++) {
+		const Latency_Stats& stats = mLatency[i];
+
+		latency.push_back({
+			static_cast<Command_Priority>(i),
+			stats.completed,
+			stats.sent,
+			(stats.sent != 0) ? stats.queueSumMs / stats.sent : 0.0,
+			stats.queueMaxMs,
+			(stats.completed != 0) ? stats.totalSumMs / stats.completed : 0.0,
+			stats.totalMaxMs,
+		});
+	}
+
+	return latency;
+}
+
+void Command_Dispatcher::Start()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	if (mRunning) {
+		return;
+	}
+
+	mRunning = true;
+	mWorker = std::thread(&Command_Dispatcher::Worker, this);
+}
+
+void Command_Dispatcher::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mRunning = false;
+	}
+
+	mTerminal.Interrupt_Await();
+
+	if (mWorker.joinable()) {
+		mWorker.join();
+	}
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	// nobody is going to send the rest
+	for (auto& sessionPair : mSessions) {
+		Node_Session& session = sessionPair.second;
+
+		if (session.inFlight != 0) {
+			Complete(session.inFlight, Command_Status::Cancelled, "Cancelled");
+			End_Flight(session);
+		}
+
+		for (std::deque<uint64_t>& queue : session.queues) {
+			for (uint64_t ticket : queue) {
+				Complete(ticket, Command_Status::Cancelled, "Cancelled");
+			}
+			queue.clear();
+		}
+	}
+
+	Fire_Completed(lck);
+}
+
+Terminal_Base& Command_Dispatcher::Get_Terminal() const
+{
+	return mTerminal;
+}
+
+Command_Dispatcher::Node_Session& Command_Dispatcher::Get_Session(const std::string& node)
+{
+	auto itr = mSessions.find(node);
+	if (itr != mSessions.end()) {
+		return itr->second;
+	}
+
+	Node_Session& session = mSessions[node];
+	session.seq = static_cast<uint8_t>(Random_Device());
+	session.rtt = RTT_Estimator(mInitialRto, mMinRto, mMaxRto);
+
+	Node_State state;
+	std::string key;
+	if (mStore == nullptr || !Get_Store_Key(node, key) || !mStore->Get(key, state)) {
+		return session;
+	}
+
+	// continuing the sequence keeps late responses to commands sent before restart from matching new ones
+	if (state.flags & Node_State_Has_Seq) {
+		session.seq = state.seq;
+	}
+	if (state.flags & Node_State_Has_Rtt) {
+		session.rtt.Restore(state.srttMs, state.rttVarMs);
+	}
+
+	uint16_t version;
+	if (mSchemas != nullptr && state.coreApiVersion != 0 && !mSchemas->Get_Node_Version(node, version)) {
+		mSchemas->Set_Node_Version(node, state.coreApiVersion);
+	}
+
+	return session;
+}
+
+bool Command_Dispatcher::Get_Store_Key(const std::string& node, std::string& key) const
+{
+	key = node.empty() ? mDefaultNode : node;
+
+	return !key.empty();
+}
+
+void Command_Dispatcher::Save_Session(const std::string& node, const Node_Session& session)
+{
+	std::string key;
+
+	if (mStore == nullptr || !Get_Store_Key(node, key)) {
+		return;
+	}
+
+	Node_State state;
+	if (!mStore->Get(key, state)) {
+		memset(&state, 0, sizeof(state));
+	}
+
+	state.seq = session.seq;
+	state.flags |= Node_State_Has_Seq;
+
+	if (session.rtt.Has_Sample()) {
+		state.srttMs = session.rtt.Get_SRTT();
+		state.rttVarMs = session.rtt.Get_RTTVAR();
+		state.flags |= Node_State_Has_Rtt;
+	}
+
+	uint16_t version;
+	if (mSchemas != nullptr && mSchemas->Get_Node_Version(node, version)) {
+		state.coreApiVersion = version;
+	}
+
+	mStore->Put(key, state);
+}
+
+bool Command_Dispatcher::Select_Queue(const Node_Session& session, std::chrono::steady_clock::time_point now, size_t& priorityClass, size_t& level) const
+{
+	bool found = false;
+	std::chrono::steady_clock::time_point oldest;
+
+	for (size_t i = 0; i < Command_Priority_Count; i++) {
+		if (session.queues[i].empty()) {
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point submitTime = mTickets.find(session.queues[i].front())->second.submitTime;
+
+		// waiting command is promoted, so bulk jobs are not starved by a stream of interactive commands
+		size_t headLevel = i;
+		if (mPriorityAgingMs > 0) {
+			const auto waitedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - submitTime).count();
+			headLevel -= std::min(headLevel, static_cast<size_t>(std::max<long long>(0, waitedMs / mPriorityAgingMs)));
+		}
+
+		// among commands of the same level, the older one goes first
+		if (!found || headLevel < level || (headLevel == level && submitTime < oldest)) {
+			found = true;
+			priorityClass = i;
+			level = headLevel;
+			oldest = submitTime;
+		}
+	}
+
+	return found;
+}
+
+long Command_Dispatcher::Reserve_Airtime(const Ticket_Entry& entry, std::chrono::steady_clock::time_point now)
+{
+	if (!mLimiter.Is_Enabled()) {
+		return 0;
+	}
+
+	return mLimiter.Acquire(entry.request.gateway, entry.request.node, mLimiter.Get_Downlink_Airtime(entry.request.packet.size()), now);
+}
+
+bool Command_Dispatcher::Select_Schema(Ticket_Entry& entry)
+{
+	Command_Request& request = entry.request;
+
+	if (mSchemas == nullptr || request.sources.empty() || request.packet.size() < sizeof(ketCube_remoteTerminal_packet_header_t)) {
+		return true;
+	}
+
+	const Command_Schema& schema = mSchemas->Get_For_Node(request.node);
+
+	ketCube_remoteTerminal_packet_header_t header;
+	memcpy(&header, request.packet.data(), sizeof(header));
+
+	if (header.coreApiVersion == schema.coreApiVersion) {
+		return true;
+	}
+
+	return mTerminal.Encode_Request(schema, static_cast<ketCube_terminal_command_opcode_t>(header.opcode), request.sources, request.packet, request.commands);
+}
+
+bool Command_Dispatcher::Handle_Api_Mismatch(Node_Session& session, Ticket_Entry& entry, const std::vector<uint8_t>& frame)
+{
+	uint16_t remoteVersion;
+
+	if (mSchemas == nullptr || entry.request.sources.empty() || !Terminal_Base::Is_Core_Api_Mismatch(frame, remoteVersion)) {
+		return false;
+	}
+
+	ketCube_remoteTerminal_packet_header_t header;
+	memcpy(&header, entry.request.packet.data(), sizeof(header));
+
+	// firmware either tells its version, or the known schemas are probed from the newest one down
+	const Command_Schema* schema = (remoteVersion != 0) ? mSchemas->Get(remoteVersion) : mSchemas->Get_Next(header.coreApiVersion);
+	if (schema == nullptr || schema->coreApiVersion == header.coreApiVersion) {
+		return false;
+	}
+
+	mSchemas->Set_Node_Version(entry.request.node, schema->coreApiVersion);
+
+	// the command goes first again, so the order of node commands is kept
+	End_Flight(session);
+	session.queues[static_cast<size_t>(entry.request.priority)].push_front(entry.result.ticket);
+	entry.result.cmdStatus.clear();
+
+	return true;
+}
+
+bool Command_Dispatcher::Transmit(Node_Session& session, Ticket_Entry& entry)
+{
+	Trace_Span span("Transmit", entry.result.ticket);
+
+	std::vector<uint8_t>& packet = entry.request.packet;
+
+	if (packet.size() < sizeof(ketCube_remoteTerminal_packet_header_t)) {
+		return false;
+	}
+
+	ketCube_remoteTerminal_packet_header_t header;
+
+	const bool retransmission = (session.inFlight == entry.result.ticket);
+
+	// retransmission keeps the sequence number, so the late response to original transmission is still accepted
+	if (!retransmission) {
+		memcpy(&header, packet.data(), sizeof(header));
+		header.seq = ++session.seq;
+		memcpy(packet.data(), &header, sizeof(header));
+
+		Save_Session(entry.request.node, session);
+	}
+
+	mOutgoing.push_back({ entry.result.ticket, entry.request.node, packet, retransmission, false });
+
+	return true;
+}
+
+void Command_Dispatcher::Send_Outgoing(std::unique_lock<std::mutex>& lck)
+{
+	std::vector<Outgoing_Packet> outgoing;
+	outgoing.swap(mOutgoing);
+
+	// publishing may block up to the connection timeout, the other threads may submit, wait and cancel meanwhile
+	lck.unlock();
+
+	for (Outgoing_Packet& out : outgoing) {
+		Trace_Span span("Send_Command", out.ticket);
+		out.sent = mTerminal.Send_Command(out.node, out.packet);
+	}
+
+	lck.lock();
+
+	for (const Outgoing_Packet& out : outgoing) {
+		auto itr = mTickets.find(out.ticket);
+
+		// cancelled while sending
+		if (itr == mTickets.end() || itr->second.result.status != Command_Status::Pending) {
+			continue;
+		}
+
+		Ticket_Entry& entry = itr->second;
+		Node_Session& session = Get_Session(out.node);
+
+		if (!out.sent) {
+			Complete(out.ticket, Command_Status::Send_Failed, out.retransmission ? "Send_Command: retransmission failed" : "Send_Command: failed to send command: " + entry.request.description);
+
+			if (session.inFlight == out.ticket) {
+				End_Flight(session);
+			}
+		} else if (!entry.request.expectResponse) {
+			// when sending "reload", we actually have no chance to send back response
+			entry.result.responseOK = true;
+			Complete(out.ticket, Command_Status::OK, "(node will be reloaded on next period timer tick; no response expected)");
+		}
+	}
+}
+
+void Command_Dispatcher::Begin_Flight(Node_Session& session, uint64_t ticket, const std::string& gateway)
+{
+	session.inFlight = ticket;
+	session.gateway = gateway;
+
+	Trace_Recorder::Async_Begin("wait for node", ticket);
+
+	mInFlightCount++;
+	mGatewayInFlight[gateway]++;
+}
+
+void Command_Dispatcher::End_Flight(Node_Session& session)
+{
+	if (session.inFlight == 0) {
+		return;
+	}
+
+	Trace_Recorder::Async_End("wait for node", session.inFlight);
+
+	session.inFlight = 0;
+
+	mInFlightCount--;
+
+	auto itr = mGatewayInFlight.find(session.gateway);
+	if (itr != mGatewayInFlight.end() && --itr->second == 0) {
+		mGatewayInFlight.erase(itr);
+	}
+}
+
+uint64_t Command_Dispatcher::Submit(Command_Request&& request, Completion_Callback callback)
+{
+	uint64_t ticket;
+
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		ticket = ++mLastTicket;
+
+		Ticket_Entry& entry = mTickets[ticket];
+		entry.request = std::move(request);
+		entry.callback = std::move(callback);
+		entry.result.ticket = ticket;
+		entry.result.description = entry.request.description;
+		entry.submitTime = std::chrono::steady_clock::now();
+
+		mOutstanding++;
+
+		Get_Session(entry.request.node).queues[static_cast<size_t>(entry.request.priority)].push_back(ticket);
+
+		Trace_Recorder::Async_Begin("command", ticket);
+	}
+
+	// wake up dispatcher thread, so it sends the command
+	mTerminal.Interrupt_Await();
+
+	return ticket;
+}
+
+bool Command_Dispatcher::Wait(uint64_t ticket, Command_Result* result)
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	auto itr = mTickets.find(ticket);
+	if (itr == mTickets.end()) {
+		return false;
+	}
+
+	// tickets with callback are erased right after the callback returns
+	if (itr->second.callback) {
+		mDone_Cv.wait(lck, [this, ticket]() { return mTickets.find(ticket) == mTickets.end(); });
+		return true;
+	}
+
+	mDone_Cv.wait(lck, [this, ticket]() {
+		auto witr = mTickets.find(ticket);
+		return witr == mTickets.end() || witr->second.done;
+	});
+
+	// another thread waited for the same ticket and took the result
+	itr = mTickets.find(ticket);
+	if (itr == mTickets.end()) {
+		return false;
+	}
+
+	if (result != nullptr) {
+		*result = std::move(itr->second.result);
+	}
+	mTickets.erase(itr);
+
+	return true;
+}
+
+void Command_Dispatcher::Wait_All()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	mDone_Cv.wait(lck, [this]() { return mOutstanding == 0; });
+}
+
+bool Command_Dispatcher::Cancel(uint64_t ticket)
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	auto itr = mTickets.find(ticket);
+	if (itr == mTickets.end() || itr->second.done || itr->second.result.status != Command_Status::Pending) {
+		return false;
+	}
+
+	Node_Session& session = Get_Session(itr->second.request.node);
+
+	if (session.inFlight == ticket) {
+		// late response will not match any command in flight and gets dropped
+		End_Flight(session);
+	} else {
+		std::deque<uint64_t>& queue = session.queues[static_cast<size_t>(itr->second.request.priority)];
+
+		for (auto qitr = queue.begin(); qitr != queue.end(); ++qitr) {
+			if (*qitr == ticket) {
+				queue.erase(qitr);
+				break;
+			}
+		}
+	}
+
+	Complete(ticket, Command_Status::Cancelled, "Cancelled");
+	Fire_Completed(lck);
+
+	lck.unlock();
+
+	// next queued command of node may be sent now
+	mTerminal.Interrupt_Await();
+
+	return true;
+}
+
+std::vector<Pending_Command_Info> Command_Dispatcher::Get_Pending()
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	std::vector<Pending_Command_Info> pending;
+
+	for (auto& entryPair : mTickets) {
+		const Ticket_Entry& entry = entryPair.second;
+
+		if (entry.result.status != Command_Status::Pending) {
+			continue;
+		}
+
+		auto sitr = mSessions.find(entry.request.node);
+		const bool inFlight = (sitr != mSessions.end() && sitr->second.inFlight == entryPair.first);
+
+		pending.push_back({ entryPair.first, entry.request.node, entry.request.description, inFlight, entry.request.priority });
+	}
+
+	return pending;
+}
+
+void Command_Dispatcher::Complete(uint64_t ticket, Command_Status status, const std::string& output)
+{
+	auto itr = mTickets.find(ticket);
+	if (itr == mTickets.end()) {
+		return;
+	}
+
+	Ticket_Entry& entry = itr->second;
+
+	entry.result.status = status;
+	entry.result.output = output;
+
+	Latency_Stats& stats = mLatency[static_cast<size_t>(entry.request.priority)];
+	const long totalMs = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - entry.submitTime).count());
+
+	stats.completed++;
+	stats.totalSumMs += totalMs;
+	stats.totalMaxMs = std::max(stats.totalMaxMs, totalMs);
+
+	Trace_Recorder::Async_End("command", ticket);
+
+	if (entry.callback) {
+		mCompleted.push_back(ticket);
+	} else {
+		entry.done = true;
+		mOutstanding--;
+		mDone_Cv.notify_all();
+	}
+}
+
+void Command_Dispatcher::Fire_Completed(std::unique_lock<std::mutex>& lck)
+{
+	while (!mCompleted.empty()) {
+		std::vector<uint64_t> completed;
+		completed.swap(mCompleted);
+
+		for (uint64_t ticket : completed) {
+			auto itr = mTickets.find(ticket);
+			if (itr == mTickets.end()) {
+				continue;
+			}
+
+			Completion_Callback callback = std::move(itr->second.callback);
+			Command_Result result = std::move(itr->second.result);
+			mTickets.erase(itr);
+
+			// callback may submit another command, so the lock must not be held
+			lck.unlock();
+			callback(result);
+			lck.lock();
+
+			mOutstanding--;
+			mDone_Cv.notify_all();
+		}
+	}
+}
+
+std::chrono::steady_clock::time_point Command_Dispatcher::Get_Deadline(const Node_Session& session, std::chrono::steady_clock::time_point now, long delayMs) const
+{
+	const std::chrono::steady_clock::time_point deadline = now + std::chrono::milliseconds(delayMs);
+
+	if (session.rtt.Has_Sample()) {
+		return deadline;
+	}
+
+	return std::min(deadline, session.sendTime + std::chrono::milliseconds(mInitialRto));
+}
+
+void Command_Dispatcher::Check_Timeouts(std::chrono::steady_clock::time_point now)
+{
+	for (auto& sessionPair : mSessions) {
+		Node_Session& session = sessionPair.second;
+
+		if (session.inFlight == 0 || now < session.deadline) {
+			continue;
+		}
+
+		Ticket_Entry& entry = mTickets[session.inFlight];
+
+		// until the first round-trip is measured, the backoff is not trusted and the command gives up within the initial timeout
+		const bool givenUp = !session.rtt.Has_Sample() && now >= session.sendTime + std::chrono::milliseconds(mInitialRto);
+
+		if (session.retransmissions >= mMaxRetransmissions || givenUp) {
+			Complete(session.inFlight, Command_Status::Timeout, "Await_Message: no response received");
+			End_Flight(session);
+			continue;
+		}
+
+		// retransmission waits for airtime budget as well
+		const long waitMs = Reserve_Airtime(entry, now);
+		if (waitMs > 0) {
+			session.deadline = Get_Deadline(session, now, waitMs);
+			continue;
+		}
+
+		session.rtt.Backoff();
+		session.retransmissions++;
+		entry.result.retransmissions = session.retransmissions;
+
+		Trace_Span span("retransmit", session.inFlight);
+
+		if (!Transmit(session, entry)) {
+			Complete(session.inFlight, Command_Status::Send_Failed, "Send_Command: retransmission failed");
+			End_Flight(session);
+			continue;
+		}
+
+		session.deadline = Get_Deadline(session, now, session.rtt.Get_RTO());
+	}
+}
+
+void Command_Dispatcher::Dispatch_Queued(std::chrono::steady_clock::time_point now)
+{
+	size_t priorityClass, level;
+
+	// nodes are served in order of priority of their next command, so interactive commands get free slots first
+	mCandidates.clear();
+	for (auto& sessionPair : mSessions) {
+		Node_Session& session = sessionPair.second;
+
+		if (session.inFlight == 0 && Select_Queue(session, now, priorityClass, level)) {
+			mCandidates.push_back({ level, mTickets[session.queues[priorityClass].front()].submitTime, &session });
+		}
+	}
+
+	std::stable_sort(mCandidates.begin(), mCandidates.end(), [](const Dispatch_Candidate& a, const Dispatch_Candidate& b) {
+		return (a.level != b.level) ? (a.level < b.level) : (a.submitTime < b.submitTime);
+	});
+
+	for (const Dispatch_Candidate& candidate : mCandidates) {
+		Node_Session& session = *candidate.session;
+
+		while (session.inFlight == 0 && Select_Queue(session, now, priorityClass, level)) {
+			if (mMaxInFlight != 0 && mInFlightCount >= mMaxInFlight) {
+				return;
+			}
+
+			std::deque<uint64_t>& queue = session.queues[priorityClass];
+			const uint64_t ticket = queue.front();
+			Ticket_Entry& entry = mTickets[ticket];
+
+			// gateway is saturated, try other nodes
+			if (mMaxInFlightPerGateway != 0) {
+				auto gitr = mGatewayInFlight.find(entry.request.gateway);
+				if (gitr != mGatewayInFlight.end() && gitr->second >= mMaxInFlightPerGateway) {
+					break;
+				}
+			}
+
+			if (now < session.releaseTime) {
+				break;
+			}
+
+			if (!Select_Schema(entry)) {
+				queue.pop_front();
+				Complete(ticket, Command_Status::Failed, "Encode_Command: command not available in core API version of node: " + entry.request.description);
+				continue;
+			}
+
+			// out of airtime budget, release the command as soon as the budget allows
+			const long waitMs = Reserve_Airtime(entry, now);
+			if (waitMs > 0) {
+				session.releaseTime = now + std::chrono::milliseconds(waitMs);
+				break;
+			}
+
+			queue.pop_front();
+
+			if (!entry.sent) {
+				Latency_Stats& stats = mLatency[priorityClass];
+				const long queueMs = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.submitTime).count());
+
+				entry.sent = true;
+				stats.sent++;
+				stats.queueSumMs += queueMs;
+				stats.queueMaxMs = std::max(stats.queueMaxMs, queueMs);
+			}
+
+			if (!Transmit(session, entry)) {
+				Complete(ticket, Command_Status::Send_Failed, "Send_Command: failed to send command: " + entry.request.description);
+				continue;
+			}
+
+			// completed once sent
+			if (!entry.request.expectResponse) {
+				continue;
+			}
+
+			Begin_Flight(session, ticket, entry.request.gateway);
+			session.retransmissions = 0;
+			session.sendTime = now;
+			session.deadline = Get_Deadline(session, now, session.rtt.Get_RTO());
+		}
+	}
+}
+
+size_t Command_Dispatcher::Get_Wait_Time(std::chrono::steady_clock::time_point now) const
+{
+	size_t waitMs = Idle_Wait_Ms;
+
+	for (auto& sessionPair : mSessions) {
+		const Node_Session& session = sessionPair.second;
+		std::chrono::steady_clock::time_point wakeup;
+
+		if (session.inFlight != 0) {
+			wakeup = session.deadline;
+		} else if (session.releaseTime > now && std::any_of(std::begin(session.queues), std::end(session.queues), [](const std::deque<uint64_t>& queue) { return !queue.empty(); })) {
+			wakeup = session.releaseTime;
+		} else {
+			continue;
+		}
+
+		const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(wakeup - now).count();
+
+		// zero timeout means waiting forever, so always wait at least a bit
+		waitMs = std::min(waitMs, static_cast<size_t>(std::max<long long>(1, remaining)));
+	}
+
+	return waitMs;
+}
+
+void Command_Dispatcher::Process_Frame(const std::string& node, const std::vector<uint8_t>& frame)
+{
+	auto sitr = mSessions.find(node);
+	if (sitr == mSessions.end() || sitr->second.inFlight == 0) {
+		// stale response to timed out or cancelled command
+		return;
+	}
+
+	Node_Session& session = sitr->second;
+	const uint64_t ticket = session.inFlight;
+	Ticket_Entry& entry = mTickets[ticket];
+
+	Trace_Span span("Process_Frame", ticket);
+
+	ketCube_remoteTerminal_packet_header_t header;
+	memcpy(&header, entry.request.packet.data(), sizeof(header));
+
+	bool result, responseOK, seqOK;
+	std::string respStr;
+
+	// values (e.g. module names) are decoded using the firmware of the node
+	const Command_Schema& schema = (mSchemas != nullptr) ? mSchemas->Get_For_Node(entry.request.node) : Command_Schema::Built_In();
+
+	entry.result.cmdStatus.clear();
+
+	if (header.opcode == KETCUBE_TERMINAL_OPCODE_BATCH) {
+		result = mTerminal.Decode_Batch_Response(frame, entry.request.commands, schema, responseOK, respStr, header.seq, seqOK, &entry.result.cmdStatus);
+	} else {
+		result = mTerminal.Decode_Single_Response(frame, entry.request.commands, schema, responseOK, respStr, header.seq, seqOK);
+	}
+
+	if (!seqOK) {
+		return;
+	}
+
+	// response to retransmitted command is ambiguous (Karn's algorithm), do not sample it
+	if (session.retransmissions == 0) {
+		session.rtt.Add_Sample(static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - session.sendTime).count()));
+	}
+
+	if (Handle_Api_Mismatch(session, entry, frame)) {
+		Save_Session(node, session);
+		return;
+	}
+
+	End_Flight(session);
+
+	// node understood the request, remember the version for the next ones
+	uint16_t remoteVersion;
+	if (result && mSchemas != nullptr && !entry.request.sources.empty() && !Terminal_Base::Is_Core_Api_Mismatch(frame, remoteVersion)) {
+		mSchemas->Set_Node_Version(node, header.coreApiVersion);
+	}
+
+	Save_Session(node, session);
+
+	if (!result) {
+		Complete(ticket, Command_Status::Failed, "Decode_Response: failed to decode incoming byte buffer");
+		return;
+	}
+
+	entry.result.responseOK = responseOK;
+	Complete(ticket, Command_Status::OK, respStr);
+}
+
+void Command_Dispatcher::Worker()
+{
+	std::vector<uint8_t> frame;
+	std::string node;
+
+	Trace_Recorder::Set_Thread_Name("dispatcher");
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	while (mRunning) {
+		auto now = std::chrono::steady_clock::now();
+
+		Check_Timeouts(now);
+		Dispatch_Queued(now);
+		Send_Outgoing(lck);
+
+		const size_t waitMs = Get_Wait_Time(now);
+
+		Fire_Completed(lck);
+
+		if (!mRunning) {
+			break;
+		}
+
+		lck.unlock();
+
+		frame.clear();
+		const bool received = mTerminal.Await_Message(node, frame, waitMs);
+
+		lck.lock();
+
+		if (received) {
+			Process_Frame(node, frame);
+		}
+	}
+}
@@ -0,0 +1,405 @@
+/**
+ * @file    command_dispatcher.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains asynchronous dispatcher of terminal commands
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+#include "terminal.h"
+#include "rtt_estimator.h"
+#include "duty_cycle_limiter.h"
+#include "schema_registry.h"
+#include "node_store.h"
+
+/*
+ * Final state of submitted command
+ */
+enum class Command_Status
+{
+	Pending,
+	OK,
+	Failed,
+	Timeout,
+	Send_Failed,
+	Cancelled,
+};
+
+// retrieves printable name of command status
+const char* Command_Status_Name(Command_Status status);
+
+/*
+ * Priority class of submitted command; lower classes are sent first
+ */
+enum class Command_Priority
+{
+	Interactive,
+	Normal,
+	Bulk,
+};
+
+// number of priority classes
+constexpr size_t Command_Priority_Count = 3;
+
+// retrieves printable name of priority class
+const char* Command_Priority_Name(Command_Priority priority);
+// parses name of priority class; returns false if it is unknown
+bool Command_Priority_Parse(const std::string& name, Command_Priority& priority);
+
+/*
+ * Command request - encoded packet with commands needed for decoding its response
+ */
+struct Command_Request
+{
+	// target node; empty for the default node of terminal
+	std::string node;
+	// gateway serving the node; used for per-gateway concurrency limit
+	std::string gateway;
+	// serialized packet; sequence number is assigned when sending
+	std::vector<uint8_t> packet;
+	// commands contained in packet, in order
+	std::vector<ketCube_terminal_cmd_t*> commands;
+	// source command lines; when present, the packet is re-encoded for the core API version of the node
+	std::vector<std::string> sources;
+	// does the node respond to this packet?
+	bool expectResponse = true;
+	// human-readable description (e.g. source command line)
+	std::string description;
+	// priority class
+	Command_Priority priority = Command_Priority::Normal;
+};
+
+/*
+ * Result of submitted command
+ */
+struct Command_Result
+{
+	// ticket of command
+	uint64_t ticket = 0;
+	// final state
+	Command_Status status = Command_Status::Pending;
+	// did the node report success of all commands?
+	bool responseOK = false;
+	// decoded response or error message
+	std::string output;
+	// OK status of every command in batch
+	std::vector<bool> cmdStatus;
+	// number of retransmissions performed
+	long retransmissions = 0;
+	// description of request
+	std::string description;
+};
+
+/*
+ * Info about command that has not completed yet
+ */
+struct Pending_Command_Info
+{
+	uint64_t ticket;
+	std::string node;
+	std::string description;
+	// was the command already sent?
+	bool inFlight;
+	// priority class
+	Command_Priority priority;
+};
+
+/*
+ * Latency of commands of single priority class
+ */
+struct Command_Latency
+{
+	Command_Priority priority;
+	// number of completed commands
+	uint64_t completed;
+	// number of commands sent
+	uint64_t sent;
+	// mean and maximum time from submission to first transmission in ms
+	double avgQueueMs;
+	long maxQueueMs;
+	// mean and maximum time from submission to completion in ms
+	double avgTotalMs;
+	long maxTotalMs;
+};
+
+// callback called on command completion (from dispatcher thread)
+using Completion_Callback = std::function<void(const Command_Result&)>;
+
+/*
+ * Command dispatcher - sends submitted commands from its own thread, matches responses by sequence number,
+ * retransmits on adaptive timeout and completes commands either by callback or by waiting for ticket;
+ * every node has at most one command in flight, since the node itself processes commands sequentially;
+ * many nodes are served in parallel within global and per-gateway concurrency limits
+ */
+class Command_Dispatcher
+{
+	private:
+		/*
+		 * Submitted command
+		 */
+		struct Ticket_Entry
+		{
+			Command_Request request;
+			Completion_Callback callback;
+			Command_Result result;
+			// has the command reached its final state?
+			bool done = false;
+			// time of submission
+			std::chrono::steady_clock::time_point submitTime;
+			// was the command transmitted at least once?
+			bool sent = false;
+		};
+
+		/*
+		 * Accumulated latency of priority class
+		 */
+		struct Latency_Stats
+		{
+			uint64_t completed = 0;
+			uint64_t sent = 0;
+			double queueSumMs = 0;
+			long queueMaxMs = 0;
+			double totalSumMs = 0;
+			long totalMaxMs = 0;
+		};
+
+		/*
+		 * Per-node state - queue of commands, command in flight, sequence number and round-trip estimator
+		 */
+		struct Node_Session
+		{
+			// commands waiting to be sent, per priority class
+			std::deque<uint64_t> queues[Command_Priority_Count];
+			// ticket of command in flight; 0 if none
+			uint64_t inFlight = 0;
+			// last used sequence number
+			uint8_t seq = 0;
+			// round-trip time estimator of this node
+			RTT_Estimator rtt;
+			// time of first transmission of command in flight
+			std::chrono::steady_clock::time_point sendTime;
+			// response deadline of command in flight
+			std::chrono::steady_clock::time_point deadline;
+			// retransmissions of command in flight
+			long retransmissions = 0;
+			// gateway of command in flight
+			std::string gateway;
+			// earliest time the next command could be sent within duty-cycle budget
+			std::chrono::steady_clock::time_point releaseTime;
+		};
+
+		/*
+		 * Packet prepared for sending; sent with the lock released, so a slow publish does not block submitters
+		 */
+		struct Outgoing_Packet
+		{
+			// ticket of command
+			uint64_t ticket;
+			// target node
+			std::string node;
+			// packet with assigned sequence number; a copy, as the ticket may be cancelled meanwhile
+			std::vector<uint8_t> packet;
+			// is this retransmission of command in flight?
+			bool retransmission;
+			// has the terminal sent the packet?
+			bool sent;
+		};
+
+		/*
+		 * Idle node with queued commands, ordered by effective priority of its next command
+		 */
+		struct Dispatch_Candidate
+		{
+			size_t level;
+			std::chrono::steady_clock::time_point submitTime;
+			Node_Session* session;
+		};
+
+		// terminal used for sending and receiving
+		Terminal_Base& mTerminal;
+
+		// all commands not yet finalized
+		std::map<uint64_t, Ticket_Entry> mTickets;
+		// per-node sessions
+		std::map<std::string, Node_Session> mSessions;
+		// tickets completed with callback, to be fired outside lock
+		std::vector<uint64_t> mCompleted;
+		// last issued ticket
+		uint64_t mLastTicket;
+		// number of tickets not finalized yet
+		size_t mOutstanding;
+		// number of commands in flight
+		size_t mInFlightCount;
+		// number of commands in flight per gateway
+		std::map<std::string, size_t> mGatewayInFlight;
+		// latency per priority class
+		Latency_Stats mLatency[Command_Priority_Count];
+		// idle nodes to be served by dispatch round; kept to reuse its memory
+		std::vector<Dispatch_Candidate> mCandidates;
+		// packets prepared by dispatch round, to be sent without the lock
+		std::vector<Outgoing_Packet> mOutgoing;
+
+		// guards all the state above
+		std::mutex mMtx;
+		// signalized when any ticket is finalized
+		std::condition_variable mDone_Cv;
+
+		// dispatcher thread
+		std::thread mWorker;
+		// is the dispatcher thread running?
+		bool mRunning;
+
+		// RTO used before first round-trip is measured
+		long mInitialRto;
+		// lower RTO bound
+		long mMinRto;
+		// upper RTO bound
+		long mMaxRto;
+		// waiting time in ms after which queued command is promoted by one priority class; 0 = never
+		long mPriorityAgingMs;
+		// maximum number of retransmissions of command without response
+		long mMaxRetransmissions;
+		// maximum number of commands in flight; 0 = unlimited
+		size_t mMaxInFlight;
+		// maximum number of commands in flight per gateway; 0 = unlimited
+		size_t mMaxInFlightPerGateway;
+		// downlink airtime budgets
+		Duty_Cycle_Limiter mLimiter;
+		// command tree schemas of known core API versions; nullptr = built-in schema only
+		Schema_Registry* mSchemas;
+		// persistent node state; nullptr = state is not kept across restarts
+		Node_Store* mStore;
+		// DevEUI of default node (lowercase); state of default node is not kept, if empty
+		std::string mDefaultNode;
+
+	protected:
+		// retrieves session of node, creates it when needed; new session starts from the stored state of node
+		Node_Session& Get_Session(const std::string& node);
+		// stores sequence number, round-trip estimate and core API version of node to node store
+		void Save_Session(const std::string& node, const Node_Session& session);
+		// retrieves key of node in node store; returns false if the node could not be stored (default node without DevEUI)
+		bool Get_Store_Key(const std::string& node, std::string& key) const;
+		// selects priority class queue of session to be served next; returns false if all queues are empty
+		bool Select_Queue(const Node_Session& session, std::chrono::steady_clock::time_point now, size_t& priorityClass, size_t& level) const;
+		// reserves airtime for packet of given ticket; returns 0 on success, otherwise time in ms until the packet could be sent
+		long Reserve_Airtime(const Ticket_Entry& entry, std::chrono::steady_clock::time_point now);
+		// re-encodes packet of given ticket for the core API version of its node; returns false if it could not be encoded
+		bool Select_Schema(Ticket_Entry& entry);
+		// handles core API mismatch response; returns true if the command was requeued with another schema
+		bool Handle_Api_Mismatch(Node_Session& session, Ticket_Entry& entry, const std::vector<uint8_t>& frame);
+		// prepares packet of given ticket for sending with next sequence number of session (or the same one, when retransmitted)
+		bool Transmit(Node_Session& session, Ticket_Entry& entry);
+		// sends prepared packets; lock must be held, it is released while sending
+		void Send_Outgoing(std::unique_lock<std::mutex>& lck);
+		// marks command of session as in flight
+		void Begin_Flight(Node_Session& session, uint64_t ticket, const std::string& gateway);
+		// clears command in flight of session
+		void End_Flight(Node_Session& session);
+		// sets final state of ticket; lock must be held
+		void Complete(uint64_t ticket, Command_Status status, const std::string& output);
+		// fires callbacks of completed tickets; lock must be held, it is released during callbacks
+		void Fire_Completed(std::unique_lock<std::mutex>& lck);
+
+		// retrieves deadline of command in flight after given delay; limited by the initial timeout until the first round-trip is measured
+		std::chrono::steady_clock::time_point Get_Deadline(const Node_Session& session, std::chrono::steady_clock::time_point now, long delayMs) const;
+		// retransmits or times out commands past their deadline
+		void Check_Timeouts(std::chrono::steady_clock::time_point now);
+		// sends queued commands to idle nodes
+		void Dispatch_Queued(std::chrono::steady_clock::time_point now);
+		// retrieves time to the nearest deadline in ms
+		size_t Get_Wait_Time(std::chrono::steady_clock::time_point now) const;
+		// matches received frame to command in flight of given node
+		void Process_Frame(const std::string& node, const std::vector<uint8_t>& frame);
+
+		// dispatcher thread routine
+		void Worker();
+
+	public:
+		Command_Dispatcher(Terminal_Base& terminal, long responseTimeoutSecs = 60);
+		~Command_Dispatcher();
+
+		// sets bounds of adaptive response timeout and maximum number of retransmissions; must be called before Start
+		void Set_Retransmission(long minResponseTimeoutSecs, long maxResponseTimeoutSecs, long maxRetransmissions);
+		// sets maximum number of commands in flight, overall and per gateway (0 = unlimited); must be called before Start
+		void Set_Concurrency(size_t maxInFlight, size_t maxInFlightPerGateway);
+		// sets downlink duty-cycle limits; must be called before Start
+		void Set_Duty_Cycle(const Duty_Cycle_Settings& settings);
+		// retrieves current usage of airtime budgets of gateways, and of nodes if requested
+		std::vector<Duty_Cycle_Usage> Get_Duty_Cycle_Usage(bool includeNodes = false);
+		// sets registry of schemas used to talk to nodes running other core API versions; must be called before Start
+		void Set_Schemas(Schema_Registry* registry);
+		// sets store used to keep node state across restarts and DevEUI the default node is stored under; must be called before Start
+		void Set_Node_Store(Node_Store* store, const std::string& defaultNode);
+		// sets waiting time after which queued command is promoted by one priority class (0 = never); must be called before Start
+		void Set_Priority_Aging(long agingSecs);
+		// retrieves latency of commands per priority class
+		std::vector<Command_Latency> Get_Latency();
+
+		// starts dispatcher thread
+		void Start();
+		// stops dispatcher thread; commands not completed yet are cancelled
+		void Stop();
+
+		// retrieves terminal used by dispatcher
+		Terminal_Base& Get_Terminal() const;
+
+		// submits command; callback (if any) is called from dispatcher thread, otherwise the result is retrieved by Wait; returns ticket
+		uint64_t Submit(Command_Request&& request, Completion_Callback callback = nullptr);
+		// waits for ticket to be finalized, retrieves result of tickets without callback; returns false for unknown ticket
+		bool Wait(uint64_t ticket, Command_Result* result = nullptr);
+		// waits for all submitted commands to complete
+		void Wait_All();
+		// cancels command; returns false if ticket is unknown or already completed
+		bool Cancel(uint64_t ticket);
+		// retrieves commands not completed yet
+		std::vector<Pending_Command_Info> Get_Pending();
+};
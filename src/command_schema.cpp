@@ -0,0 +1,88 @@
+/**
+ * @file    command_schema.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of command tree schema
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "command_schema.h"
+
+ketCube_moduleID_t Command_Schema::Lookup_Module_Id(const std::string& moduleName) const
+{
+	for (const Schema_Module& module : modules) {
+		if (moduleName == module.name) {
+			return module.id;
+		}
+	}
+
+	return KETCUBE_MODULEID_INVALID;
+}
+
+const char* Command_Schema::Lookup_Module_Name(ketCube_moduleID_t moduleId) const
+{
+	for (const Schema_Module& module : modules) {
+		if (module.id == moduleId) {
+			return module.name;
+		}
+	}
+
+	return nullptr;
+}
+
+const Command_Schema& Command_Schema::Built_In()
+{
+	static const Command_Schema schema = []() {
+		Command_Schema builtIn;
+
+		builtIn.coreApiVersion = KETCUBE_MODULEID_CORE_API;
+		builtIn.root = get_cmd_tree();
+
+		const ketCube_cfg_Module_t* modlist = get_module_list();
+		const size_t modcnt = get_module_count();
+
+		for (size_t i = KETCUBE_LISTS_MODULEID_FIRST; i < modcnt; i++) {
+			builtIn.modules.push_back({ modlist[i].id, &(modlist[i].name[0]) });
+		}
+
+		return builtIn;
+	}();
+
+	return schema;
+}
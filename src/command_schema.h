@@ -0,0 +1,81 @@
+/**
+ * @file    command_schema.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains command tree schema used for encoding and decoding commands
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "impl_bridge.h"
+
+/*
+ * Module known to schema
+ */
+struct Schema_Module
+{
+	ketCube_moduleID_t id;				// module ID
+	const char* name;					// module name
+};
+
+/*
+ * Command schema - command tree and module list of one firmware core API version
+ */
+struct Command_Schema
+{
+	// core API version of firmware the schema describes
+	uint16_t coreApiVersion;
+	// root of command tree
+	ketCube_terminal_cmd_t* root;
+	// modules of firmware
+	std::vector<Schema_Module> modules;
+
+	// retrieves ID of module with given name; KETCUBE_MODULEID_INVALID if not found
+	ketCube_moduleID_t Lookup_Module_Id(const std::string& moduleName) const;
+	// retrieves name of module with given ID; nullptr if not found
+	const char* Lookup_Module_Name(ketCube_moduleID_t moduleId) const;
+
+	// retrieves schema compiled into the application
+	static const Command_Schema& Built_In();
+};
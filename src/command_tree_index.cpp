@@ -0,0 +1,128 @@
+/**
+ * @file    command_tree_index.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains stable indexing of command tree entries implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "command_tree_index.h"
+
+constexpr uint32_t Command_Tree_Index::Invalid_Index;
+
+// FNV-1a hashing of given bytes
+static uint32_t Fingerprint_Update(uint32_t hash, const void* data, size_t len)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+Command_Tree_Index::Command_Tree_Index(ketCube_terminal_cmd_t* root)
+	: mFingerprint(2166136261u)
+{
+	Add_Subtree(root);
+}
+
+void Command_Tree_Index::Add_Subtree(ketCube_terminal_cmd_t* subtree)
+{
+	uint8_t attrs[4];
+
+	for (size_t i = 0; subtree[i].cmd != nullptr; i++) {
+
+		ketCube_terminal_cmd_t* entry = &subtree[i];
+
+		// subtrees may be shared among multiple parents; index every entry just once
+		if (mIndices.find(entry) != mIndices.end()) {
+			continue;
+		}
+
+		mIndices[entry] = static_cast<uint32_t>(mEntries.size());
+		mEntries.push_back(entry);
+
+		// fingerprint covers everything encoding and decoding depends on
+		attrs[0] = static_cast<uint8_t>(entry->paramSetType);
+		attrs[1] = static_cast<uint8_t>(entry->outputSetType);
+		attrs[2] = static_cast<uint8_t>(entry->moduleId & 0xFF);
+		attrs[3] = static_cast<uint8_t>(((entry->flags.isGroup ? 1 : 0) << 0) | ((entry->flags.isRemote ? 1 : 0) << 1));
+
+		mFingerprint = Fingerprint_Update(mFingerprint, entry->cmd, strlen(entry->cmd) + 1);
+		mFingerprint = Fingerprint_Update(mFingerprint, attrs, sizeof(attrs));
+
+		if (entry->flags.isGroup && entry->settingsPtr.subCmdList != nullptr) {
+			Add_Subtree(entry->settingsPtr.subCmdList);
+		}
+	}
+}
+
+uint32_t Command_Tree_Index::Get_Index(const ketCube_terminal_cmd_t* entry) const
+{
+	auto itr = mIndices.find(entry);
+	if (itr == mIndices.end()) {
+		return Invalid_Index;
+	}
+
+	return itr->second;
+}
+
+ketCube_terminal_cmd_t* Command_Tree_Index::Get_Entry(uint32_t index) const
+{
+	if (index >= mEntries.size()) {
+		return nullptr;
+	}
+
+	return mEntries[index];
+}
+
+size_t Command_Tree_Index::Get_Count() const
+{
+	return mEntries.size();
+}
+
+uint32_t Command_Tree_Index::Get_Fingerprint() const
+{
+	return mFingerprint;
+}
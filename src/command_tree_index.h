@@ -0,0 +1,84 @@
+/**
+ * @file    command_tree_index.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains stable indexing of command tree entries
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <map>
+
+#include "impl_bridge.h"
+
+/*
+ * Flat index of command tree entries; indices are stable for the same command tree
+ */
+class Command_Tree_Index
+{
+	private:
+		// all entries in depth-first order
+		std::vector<ketCube_terminal_cmd_t*> mEntries;
+		// reverse lookup; entry -> index
+		std::map<const ketCube_terminal_cmd_t*, uint32_t> mIndices;
+		// fingerprint of tree shape and contents
+		uint32_t mFingerprint;
+
+	protected:
+		// recursively adds subtree entries
+		void Add_Subtree(ketCube_terminal_cmd_t* subtree);
+
+	public:
+		// index value of entries not found in tree
+		static constexpr uint32_t Invalid_Index = 0xFFFFFFFF;
+
+		Command_Tree_Index(ketCube_terminal_cmd_t* root);
+
+		// retrieves index of given entry; Invalid_Index if not found
+		uint32_t Get_Index(const ketCube_terminal_cmd_t* entry) const;
+		// retrieves entry on given index; nullptr if out of range
+		ketCube_terminal_cmd_t* Get_Entry(uint32_t index) const;
+		// retrieves number of indexed entries
+		size_t Get_Count() const;
+		// retrieves tree fingerprint, so the indices could be verified to match
+		uint32_t Get_Fingerprint() const;
+};
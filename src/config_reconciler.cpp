@@ -0,0 +1,181 @@
+/**
+ * @file    config_reconciler.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of desired-state configuration reconciler
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <sstream>
+
+#include "config_reconciler.h"
+
+Config_Reconciler::Config_Reconciler(const Terminal_Base& terminal, const std::string& node)
+	: mTerminal(terminal), mNode(node)
+{
+	//
+}
+
+std::string Config_Reconciler::Normalize(const std::string& cmd)
+{
+	std::istringstream istr(cmd);
+	std::string word, out;
+
+	while (istr >> word) {
+		if (!out.empty()) {
+			out += ' ';
+		}
+		out += word;
+	}
+
+	return out;
+}
+
+bool Config_Reconciler::Load_Profile(std::istream& input, std::ostream& errOutput)
+{
+	std::string line, key;
+	std::map<std::string, size_t> keyPositions;
+	bool success = true;
+
+	mDesired.clear();
+
+	while (std::getline(input, line)) {
+
+		Setting setting;
+		setting.cmd = Normalize(line);
+
+		// skip empty lines and comments
+		if (setting.cmd.empty() || setting.cmd[0] == ';' || setting.cmd[0] == '#') {
+			continue;
+		}
+
+		if (!mTerminal.Get_Setting_Key(setting.cmd, key, setting.value)) {
+			errOutput << "Profile: not a setting command: " << setting.cmd << std::endl;
+			success = false;
+			continue;
+		}
+
+		// later occurrence of the same setting wins, but keeps the position of the first one
+		auto itr = keyPositions.find(key);
+		if (itr != keyPositions.end()) {
+			mDesired[itr->second].second = std::move(setting);
+		} else {
+			keyPositions[key] = mDesired.size();
+			mDesired.emplace_back(key, std::move(setting));
+		}
+	}
+
+	return success;
+}
+
+void Config_Reconciler::Load_State(std::istream& input)
+{
+	std::string line, node;
+	bool inSection = false;
+
+	while (std::getline(input, line)) {
+		const std::string cmd = Normalize(line);
+
+		if (cmd.size() >= 2 && cmd.front() == '[' && cmd.back() == ']') {
+			node = cmd.substr(1, cmd.size() - 2);
+			inSection = true;
+			continue;
+		}
+
+		// settings outside of node section could belong to any node, so they are not trusted
+		if (inSection) {
+			Learn(node, cmd);
+		}
+	}
+}
+
+void Config_Reconciler::Save_State(std::ostream& output) const
+{
+	for (auto& nodeState : mKnown) {
+		output << "[" << nodeState.first << "]" << std::endl;
+
+		for (auto& setting : nodeState.second) {
+			output << setting.second.cmd << std::endl;
+		}
+	}
+}
+
+void Config_Reconciler::Learn(const std::string& node, const std::string& cmd)
+{
+	std::string key;
+	Setting setting;
+
+	setting.cmd = Normalize(cmd);
+
+	if (mTerminal.Get_Setting_Key(setting.cmd, key, setting.value)) {
+		mKnown[node][key] = std::move(setting);
+	}
+}
+
+void Config_Reconciler::Learn(const std::string& cmd)
+{
+	Learn(mNode, cmd);
+}
+
+std::vector<std::string> Config_Reconciler::Diff() const
+{
+	std::vector<std::string> diff;
+
+	auto nitr = mKnown.find(mNode);
+
+	for (auto& setting : mDesired) {
+		if (nitr == mKnown.end()) {
+			diff.push_back(setting.second.cmd);
+			continue;
+		}
+
+		// settings are compared by encoded value, so e.g. "0100" and "100" are the same
+		auto itr = nitr->second.find(setting.first);
+		if (itr == nitr->second.end() || itr->second.value != setting.second.value) {
+			diff.push_back(setting.second.cmd);
+		}
+	}
+
+	return diff;
+}
+
+size_t Config_Reconciler::Get_Profile_Size() const
+{
+	return mDesired.size();
+}
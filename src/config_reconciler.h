@@ -0,0 +1,104 @@
+/**
+ * @file    config_reconciler.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains desired-state configuration reconciler
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "terminal.h"
+
+/*
+ * Reconciler of desired node configuration (profile) against last-known node state
+ */
+class Config_Reconciler
+{
+	private:
+		/*
+		 * Setting of profile or state - command and its encoded value
+		 */
+		struct Setting
+		{
+			// normalized command
+			std::string cmd;
+			// encoded parameters (or the whole command for module settings)
+			std::vector<uint8_t> value;
+		};
+
+		// terminal used for command tree lookups
+		const Terminal_Base& mTerminal;
+		// node the profile is reconciled with
+		std::string mNode;
+
+		// desired settings in profile order; pairs of setting key and setting
+		std::vector<std::pair<std::string, Setting>> mDesired;
+		// last-known settings per node; node -> setting key -> setting
+		std::map<std::string, std::map<std::string, Setting>> mKnown;
+
+	protected:
+		// collapses whitespaces in command, so equal commands compare equal
+		static std::string Normalize(const std::string& cmd);
+		// records setting command to last-known state of given node
+		void Learn(const std::string& node, const std::string& cmd);
+
+	public:
+		Config_Reconciler(const Terminal_Base& terminal, const std::string& node);
+
+		// loads desired configuration profile; returns false if any of lines is not a setting command
+		bool Load_Profile(std::istream& input, std::ostream& errOutput);
+		// loads last-known state of all nodes ("[node]" section followed by setting commands); unknown lines are skipped
+		void Load_State(std::istream& input);
+		// stores last-known state of all nodes in format accepted by Load_State
+		void Save_State(std::ostream& output) const;
+
+		// records successfully applied command to last-known state of the node
+		void Learn(const std::string& cmd);
+
+		// retrieves commands needed to reach desired state, in profile order
+		std::vector<std::string> Diff() const;
+		// retrieves number of settings in profile
+		size_t Get_Profile_Size() const;
+};
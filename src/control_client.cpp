@@ -0,0 +1,275 @@
+/**
+ * @file    control_client.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of daemon control socket client
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "control_client.h"
+#include "control_protocol.h"
+
+Control_Client::Control_Client(std::ostream& output)
+	: mFd(-1), mOutput(output), mLastId(0), mDisconnected(false)
+{
+	//
+}
+
+Control_Client::~Control_Client()
+{
+#ifndef _WIN32
+	if (mFd >= 0) {
+		close(mFd);
+	}
+#endif
+}
+
+bool Control_Client::Connect(const std::string& path)
+{
+#ifndef _WIN32
+	sockaddr_un addr{};
+
+	if (path.size() >= sizeof(addr.sun_path)) {
+		std::cerr << "Control socket path is too long: " << path << std::endl;
+		return false;
+	}
+
+	addr.sun_family = AF_UNIX;
+	path.copy(addr.sun_path, path.size());
+
+	mFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (mFd < 0 || connect(mFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		std::cerr << "Could not connect to daemon on control socket: " << path << std::endl;
+		return false;
+	}
+
+	return true;
+#else
+	std::cerr << "Control socket is not supported on this platform" << std::endl;
+	return false;
+#endif
+}
+
+bool Control_Client::Send_Request(json11::Json::object&& request, const std::string& description)
+{
+	uint64_t id;
+
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		if (mDisconnected) {
+			return false;
+		}
+
+		// registered before sending, so the reply could not arrive earlier
+		id = ++mLastId;
+		mOutstanding[id] = description;
+	}
+
+	request["id"] = static_cast<double>(id);
+
+	// only input thread writes; the lock must not be held, the reader has to keep draining replies meanwhile
+	if (!Control_Write_Frame(mFd, json11::Json(request).dump())) {
+		std::unique_lock<std::mutex> lck(mMtx);
+		mOutstanding.erase(id);
+		return false;
+	}
+
+	return true;
+}
+
+bool Control_Client::Print_Reply(const json11::Json& reply)
+{
+	const std::string& event = reply["event"].string_value();
+	const std::string ticket = "[#" + std::to_string(static_cast<uint64_t>(reply["ticket"].number_value())) + "] ";
+
+	if (event == "submitted") {
+		mOutput << ticket << "submitted: " << mOutstanding[static_cast<uint64_t>(reply["id"].number_value())] << std::endl;
+		return false;
+	} else if (event == "result") {
+		if (reply["retransmissions"].number_value() > 0) {
+			mOutput << ticket << "(command retransmitted " << reply["retransmissions"].number_value() << " times)" << std::endl;
+		}
+		(reply["status"].string_value() == "ok" ? mOutput : std::cerr) << ticket << reply["output"].string_value() << std::endl;
+	} else if (event == "pending") {
+		if (reply["commands"].array_items().empty()) {
+			mOutput << "No pending commands" << std::endl;
+		}
+		for (const json11::Json& info : reply["commands"].array_items()) {
+			mOutput << "[#" << static_cast<uint64_t>(info["ticket"].number_value()) << "] "
+				<< (info["inFlight"].bool_value() ? "in flight" : "queued") << " (" << info["priority"].string_value() << "): " << info["description"].string_value() << std::endl;
+		}
+	} else if (event == "cancel") {
+		if (!reply["ok"].bool_value()) {
+			mOutput << "Unknown or already completed ticket" << std::endl;
+		}
+	} else if (event == "stats") {
+		if (reply["usage"].array_items().empty()) {
+			mOutput << "No airtime consumed" << std::endl;
+		}
+		for (const json11::Json& use : reply["usage"].array_items()) {
+			mOutput << use["scope"].string_value() << " " << (use["id"].string_value().empty() ? "(any)" : use["id"].string_value())
+				<< ": consumed " << use["consumedMs"].number_value() << " ms, available " << use["availableMs"].number_value()
+				<< " of " << use["capacityMs"].number_value() << " ms" << std::endl;
+		}
+		for (const json11::Json& lat : reply["latency"].array_items()) {
+			mOutput << lat["priority"].string_value() << ": " << lat["completed"].number_value() << " completed, queued avg " << static_cast<long>(lat["avgQueueMs"].number_value())
+				<< " ms / max " << lat["maxQueueMs"].number_value() << " ms, total avg " << static_cast<long>(lat["avgTotalMs"].number_value()) << " ms / max "
+				<< lat["maxTotalMs"].number_value() << " ms" << std::endl;
+		}
+	} else if (event == "error") {
+		std::cerr << "Daemon error: " << reply["error"].string_value() << std::endl;
+	}
+
+	return true;
+}
+
+void Control_Client::Reader()
+{
+	std::string message, err;
+
+	while (Control_Read_Frame(mFd, message)) {
+		const json11::Json reply = json11::Json::parse(message, err);
+		if (!err.empty()) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		if (Print_Reply(reply)) {
+			mOutstanding.erase(static_cast<uint64_t>(reply["id"].number_value()));
+			mDone_Cv.notify_all();
+		}
+	}
+
+	std::unique_lock<std::mutex> lck(mMtx);
+	mDisconnected = true;
+	mDone_Cv.notify_all();
+}
+
+int Control_Client::Run(std::istream& input, const std::string& node, size_t maxBatchCommands)
+{
+	std::vector<std::string> batch;
+	std::string line;
+	bool batchMode = false;
+
+	std::thread reader(&Control_Client::Reader, this);
+
+	auto submit = [&](const std::vector<std::string>& commands, bool isBatch, const std::string& description) {
+		json11::Json::array cmds(commands.begin(), commands.end());
+
+		if (!Send_Request(json11::Json::object{ { "op", "submit" }, { "node", node }, { "commands", cmds }, { "batch", isBatch }, { "priority", "interactive" } }, description)) {
+			std::cerr << "Could not send request to daemon" << std::endl;
+		}
+	};
+
+	while (std::getline(input, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		std::istringstream ss(line);
+		std::string cmd, ticketStr;
+		ss >> cmd >> ticketStr;
+
+		if (line == "!batch") {
+			batchMode = true;
+			batch.clear();
+		} else if (line == "!commit") {
+			if (!batchMode || batch.empty()) {
+				std::cerr << "No batch to commit" << std::endl;
+			} else {
+				submit(batch, true, "batch of " + std::to_string(batch.size()) + " commands");
+			}
+			batchMode = false;
+		} else if (line == "!abort") {
+			batchMode = false;
+		} else if (cmd == "!pending" || cmd == "!stats") {
+			Send_Request(json11::Json::object{ { "op", cmd.substr(1) } }, cmd);
+		} else if (cmd == "!cancel") {
+			if (ticketStr.empty() || ticketStr.find_first_not_of("0123456789") != std::string::npos) {
+				std::cerr << "Usage: !cancel <ticket>" << std::endl;
+			} else {
+				const uint64_t ticket = std::strtoull(ticketStr.c_str(), nullptr, 10);
+				Send_Request(json11::Json::object{ { "op", "cancel" }, { "ticket", static_cast<double>(ticket) } }, line);
+			}
+		} else if (line[0] == '!') {
+			std::cerr << "Unknown control command: " << line << std::endl;
+		} else if (batchMode) {
+			if (batch.size() >= maxBatchCommands) {
+				std::cerr << "Maximum number of batch commands reached: " << batch.size() << "; please, perform !commit" << std::endl;
+			} else {
+				batch.push_back(line);
+			}
+		} else {
+			submit({ line }, false, line);
+		}
+	}
+
+	int ret = 0;
+
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mDone_Cv.wait(lck, [this]() { return mOutstanding.empty() || mDisconnected; });
+
+		if (!mOutstanding.empty()) {
+			std::cerr << "Connection to daemon lost with " << mOutstanding.size() << " requests unfinished" << std::endl;
+			ret = 2;
+		}
+	}
+
+#ifndef _WIN32
+	shutdown(mFd, SHUT_RDWR);
+#endif
+	reader.join();
+
+	return ret;
+}
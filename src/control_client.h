@@ -0,0 +1,94 @@
+/**
+ * @file    control_client.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains thin client of daemon control socket
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+#include "json11.hpp"
+
+/*
+ * Control socket client - sends commands read from input to running daemon and prints their results
+ */
+class Control_Client
+{
+	private:
+		// connected socket; -1 if not connected
+		int mFd;
+		// output stream for results
+		std::ostream& mOutput;
+
+		// last used request ID
+		uint64_t mLastId;
+		// requests without final reply; request ID -> description
+		std::map<uint64_t, std::string> mOutstanding;
+		// guards outstanding requests and output
+		std::mutex mMtx;
+		// signalized when request is finished
+		std::condition_variable mDone_Cv;
+		// was the connection closed by daemon?
+		bool mDisconnected;
+
+	protected:
+		// sends request, registers it as outstanding; returns false on failure
+		bool Send_Request(json11::Json::object&& request, const std::string& description);
+		// reader thread routine - prints replies of daemon
+		void Reader();
+		// prints single reply; returns true if it is final reply of request
+		bool Print_Reply(const json11::Json& reply);
+
+	public:
+		Control_Client(std::ostream& output);
+		~Control_Client();
+
+		// connects to daemon listening on given socket path; returns false on failure
+		bool Connect(const std::string& path);
+		// submits commands read from input (with !batch, !commit, !abort, !pending, !cancel and !stats control commands),
+		// waits for all results
+		int Run(std::istream& input, const std::string& node, size_t maxBatchCommands);
+};
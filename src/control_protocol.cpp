@@ -0,0 +1,199 @@
+/**
+ * @file    control_protocol.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of control socket protocol framing
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "control_protocol.h"
+
+bool Control_Parse_Submission(const Terminal_Base& terminal, size_t maxBatchCommands, Command_Priority defaultPriority, const json11::Json& submission, Command_Request& request, std::string& error)
+{
+	request.node = submission["node"].string_value();
+	request.gateway = submission["gateway"].string_value();
+
+	// DevEUIs are compared in lowercase
+	std::transform(request.node.begin(), request.node.end(), request.node.begin(), ::tolower);
+
+	for (const json11::Json& cmd : submission["commands"].array_items()) {
+		request.sources.push_back(cmd.string_value());
+	}
+
+	const bool batch = submission["batch"].bool_value() || request.sources.size() > 1;
+
+	if (request.sources.empty()) {
+		error = "no commands to submit";
+		return false;
+	}
+
+	request.priority = defaultPriority;
+	if (!submission["priority"].is_null() && !Command_Priority_Parse(submission["priority"].string_value(), request.priority)) {
+		error = "unknown priority: " + submission["priority"].string_value();
+		return false;
+	}
+
+	if (batch && request.sources.size() > maxBatchCommands) {
+		error = "maximum number of batch commands exceeded: " + std::to_string(request.sources.size());
+		return false;
+	}
+
+	if (!terminal.Encode_Request(Command_Schema::Built_In(), batch ? KETCUBE_TERMINAL_OPCODE_BATCH : KETCUBE_TERMINAL_OPCODE_CMD,
+		request.sources, request.packet, request.commands)) {
+		error = "unknown command in request";
+		return false;
+	}
+
+	// when sending "reload", we actually have no chance to send back response
+	request.expectResponse = batch || request.sources[0] != "reload";
+	request.description = batch ? "batch of " + std::to_string(request.sources.size()) + " commands" : request.sources[0];
+
+	return true;
+}
+
+json11::Json::object Control_Result_Json(const Command_Result& result)
+{
+	json11::Json::array cmdStatus;
+	for (bool ok : result.cmdStatus) {
+		cmdStatus.push_back(ok);
+	}
+
+	return json11::Json::object{
+		{ "ticket", static_cast<double>(result.ticket) },
+		{ "status", Command_Status_Name(result.status) },
+		{ "responseOk", result.responseOK },
+		{ "output", result.output },
+		{ "cmdStatus", cmdStatus },
+		{ "retransmissions", static_cast<double>(result.retransmissions) },
+	};
+}
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <cerrno>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static bool Write_All(int fd, const uint8_t* data, size_t len)
+{
+	while (len > 0) {
+		// closed peer must not kill the whole process with SIGPIPE
+		const ssize_t written = send(fd, data, len, MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return false;
+		}
+
+		data += written;
+		len -= static_cast<size_t>(written);
+	}
+
+	return true;
+}
+
+static bool Read_All(int fd, uint8_t* data, size_t len)
+{
+	while (len > 0) {
+		const ssize_t rd = recv(fd, data, len, 0);
+		if (rd < 0 && errno == EINTR) {
+			continue;
+		}
+		if (rd <= 0) {
+			return false;
+		}
+
+		data += rd;
+		len -= static_cast<size_t>(rd);
+	}
+
+	return true;
+}
+
+bool Control_Write_Frame(int fd, const std::string& message)
+{
+	if (message.size() > Control_Max_Frame_Length) {
+		return false;
+	}
+
+	const uint32_t len = static_cast<uint32_t>(message.size());
+	const uint8_t prefix[4] = {
+		static_cast<uint8_t>(len >> 24), static_cast<uint8_t>(len >> 16), static_cast<uint8_t>(len >> 8), static_cast<uint8_t>(len)
+	};
+
+	return Write_All(fd, prefix, sizeof(prefix)) && Write_All(fd, reinterpret_cast<const uint8_t*>(message.data()), message.size());
+}
+
+bool Control_Read_Frame(int fd, std::string& message)
+{
+	uint8_t prefix[4];
+
+	if (!Read_All(fd, prefix, sizeof(prefix))) {
+		return false;
+	}
+
+	const uint32_t len = (static_cast<uint32_t>(prefix[0]) << 24) | (static_cast<uint32_t>(prefix[1]) << 16) | (static_cast<uint32_t>(prefix[2]) << 8) | prefix[3];
+	if (len > Control_Max_Frame_Length) {
+		return false;
+	}
+
+	message.resize(len);
+
+	return len == 0 || Read_All(fd, reinterpret_cast<uint8_t*>(&message[0]), len);
+}
+
+#else
+
+bool Control_Write_Frame(int, const std::string&)
+{
+	return false;
+}
+
+bool Control_Read_Frame(int, std::string&)
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file    control_protocol.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains framing of control socket protocol
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "command_dispatcher.h"
+
+#include "json11.hpp"
+
+/*
+ * Control socket protocol - every message is JSON object prefixed by its length (4 bytes, big endian)
+ */
+
+// maximum length of single message
+constexpr uint32_t Control_Max_Frame_Length = 1024 * 1024;
+
+// writes single message to socket; returns false on failure
+bool Control_Write_Frame(int fd, const std::string& message);
+// reads single message from socket; returns false on failure or when the peer closed the connection
+bool Control_Read_Frame(int fd, std::string& message);
+
+// builds command request from JSON submission {"node", "gateway", "commands": [...], "batch", "priority"}; returns false with error message if it is invalid
+bool Control_Parse_Submission(const Terminal_Base& terminal, size_t maxBatchCommands, Command_Priority defaultPriority, const json11::Json& submission, Command_Request& request, std::string& error);
+// converts command result to JSON object
+json11::Json::object Control_Result_Json(const Command_Result& result);
@@ -0,0 +1,337 @@
+/**
+ * @file    control_server.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of control socket server
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <csignal>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "control_server.h"
+#include "control_protocol.h"
+
+// how often the accept loop checks for termination request
+constexpr int Accept_Poll_Ms = 500;
+
+// set by signal handler, when the daemon should terminate
+static volatile std::sig_atomic_t Terminate_Requested = 0;
+
+static void Handle_Terminate_Signal(int)
+{
+	Terminate_Requested = 1;
+}
+
+Control_Server::Control_Server(Command_Dispatcher& dispatcher, size_t maxBatchCommands)
+	: mDispatcher(dispatcher), mMaxBatchCommands(maxBatchCommands), mListenFd(-1)
+{
+	//
+}
+
+Control_Server::~Control_Server()
+{
+	Close();
+}
+
+#ifndef _WIN32
+
+bool Control_Server::Open(const std::string& path)
+{
+	sockaddr_un addr{};
+
+	if (path.size() >= sizeof(addr.sun_path)) {
+		std::cerr << "Control socket path is too long: " << path << std::endl;
+		return false;
+	}
+
+	addr.sun_family = AF_UNIX;
+	path.copy(addr.sun_path, path.size());
+
+	mListenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (mListenFd < 0) {
+		std::cerr << "Could not create control socket" << std::endl;
+		return false;
+	}
+
+	// socket file left behind by previous instance would block the bind
+	unlink(path.c_str());
+
+	if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(mListenFd, 16) != 0) {
+		std::cerr << "Could not listen on control socket: " << path << std::endl;
+		close(mListenFd);
+		mListenFd = -1;
+		return false;
+	}
+
+	mPath = path;
+
+	return true;
+}
+
+int Control_Server::Run()
+{
+	if (mListenFd < 0) {
+		return 3;
+	}
+
+	Terminate_Requested = 0;
+	std::signal(SIGINT, Handle_Terminate_Signal);
+	std::signal(SIGTERM, Handle_Terminate_Signal);
+
+	std::cout << "Listening on control socket " << mPath << std::endl;
+
+	while (!Terminate_Requested) {
+		pollfd pfd{ mListenFd, POLLIN, 0 };
+
+		if (poll(&pfd, 1, Accept_Poll_Ms) <= 0 || !(pfd.revents & POLLIN)) {
+			Reap_Connections(false);
+			continue;
+		}
+
+		const int fd = accept(mListenFd, nullptr, nullptr);
+		if (fd < 0) {
+			continue;
+		}
+
+		std::shared_ptr<Connection> conn = std::make_shared<Connection>();
+		conn->fd = fd;
+		conn->thread = std::thread(&Control_Server::Serve, this, conn);
+
+		mConnections.push_back(conn);
+
+		Reap_Connections(false);
+	}
+
+	std::signal(SIGINT, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+
+	Close();
+
+	return 0;
+}
+
+void Control_Server::Close()
+{
+	if (mListenFd >= 0) {
+		close(mListenFd);
+		mListenFd = -1;
+		unlink(mPath.c_str());
+	}
+
+	// wakes up client threads blocked in reading
+	for (auto& conn : mConnections) {
+		std::unique_lock<std::mutex> lck(conn->writeMtx);
+		if (conn->fd >= 0) {
+			shutdown(conn->fd, SHUT_RDWR);
+		}
+	}
+
+	Reap_Connections(true);
+}
+
+void Control_Server::Close(Connection& conn)
+{
+	std::unique_lock<std::mutex> lck(conn.writeMtx);
+
+	if (conn.fd >= 0) {
+		close(conn.fd);
+		conn.fd = -1;
+	}
+}
+
+#else
+
+bool Control_Server::Open(const std::string& path)
+{
+	std::cerr << "Control socket is not supported on this platform" << std::endl;
+	return false;
+}
+
+int Control_Server::Run()
+{
+	return 3;
+}
+
+void Control_Server::Close()
+{
+	//
+}
+
+void Control_Server::Close(Connection& conn)
+{
+	//
+}
+
+#endif
+
+bool Control_Server::Send(Connection& conn, const json11::Json& message)
+{
+	std::unique_lock<std::mutex> lck(conn.writeMtx);
+
+	return conn.fd >= 0 && Control_Write_Frame(conn.fd, message.dump());
+}
+
+void Control_Server::Reap_Connections(bool all)
+{
+	for (auto itr = mConnections.begin(); itr != mConnections.end(); ) {
+		if (all || (*itr)->finished) {
+			if ((*itr)->thread.joinable()) {
+				(*itr)->thread.join();
+			}
+			itr = mConnections.erase(itr);
+		} else {
+			++itr;
+		}
+	}
+}
+
+void Control_Server::Serve(std::shared_ptr<Connection> conn)
+{
+	std::string message, err;
+
+	while (Control_Read_Frame(conn->fd, message)) {
+		const json11::Json request = json11::Json::parse(message, err);
+
+		if (!err.empty() || !request.is_object()) {
+			Send(*conn, json11::Json::object{ { "event", "error" }, { "error", "malformed request: " + err } });
+			continue;
+		}
+
+		Process_Request(conn, request);
+	}
+
+	// commands already submitted keep running, their results are just dropped
+	Close(*conn);
+	conn->finished = true;
+}
+
+void Control_Server::Process_Request(const std::shared_ptr<Connection>& conn, const json11::Json& request)
+{
+	const std::string& op = request["op"].string_value();
+	const json11::Json& id = request["id"];
+
+	if (op == "submit") {
+		Submit(conn, request);
+	} else if (op == "pending") {
+		json11::Json::array commands;
+
+		for (const Pending_Command_Info& info : mDispatcher.Get_Pending()) {
+			commands.push_back(json11::Json::object{
+				{ "ticket", static_cast<double>(info.ticket) },
+				{ "node", info.node },
+				{ "description", info.description },
+				{ "inFlight", info.inFlight },
+				{ "priority", Command_Priority_Name(info.priority) },
+			});
+		}
+
+		Send(*conn, json11::Json::object{ { "event", "pending" }, { "id", id }, { "commands", commands } });
+	} else if (op == "cancel") {
+		const uint64_t ticket = static_cast<uint64_t>(request["ticket"].number_value());
+
+		Send(*conn, json11::Json::object{ { "event", "cancel" }, { "id", id }, { "ok", mDispatcher.Cancel(ticket) } });
+	} else if (op == "stats") {
+		json11::Json::array usage;
+
+		for (const Duty_Cycle_Usage& use : mDispatcher.Get_Duty_Cycle_Usage(true)) {
+			usage.push_back(json11::Json::object{
+				{ "scope", use.scope },
+				{ "id", use.id },
+				{ "consumedMs", use.consumedMs },
+				{ "availableMs", use.availableMs },
+				{ "capacityMs", use.capacityMs },
+			});
+		}
+
+		json11::Json::array latency;
+
+		for (const Command_Latency& lat : mDispatcher.Get_Latency()) {
+			latency.push_back(json11::Json::object{
+				{ "priority", Command_Priority_Name(lat.priority) },
+				{ "completed", static_cast<double>(lat.completed) },
+				{ "sent", static_cast<double>(lat.sent) },
+				{ "avgQueueMs", lat.avgQueueMs },
+				{ "maxQueueMs", static_cast<double>(lat.maxQueueMs) },
+				{ "avgTotalMs", lat.avgTotalMs },
+				{ "maxTotalMs", static_cast<double>(lat.maxTotalMs) },
+			});
+		}
+
+		Send(*conn, json11::Json::object{ { "event", "stats" }, { "id", id }, { "usage", usage }, { "latency", latency } });
+	} else {
+		Send(*conn, json11::Json::object{ { "event", "error" }, { "id", id }, { "error", "unknown operation: " + op } });
+	}
+}
+
+void Control_Server::Submit(const std::shared_ptr<Connection>& conn, const json11::Json& request)
+{
+	const json11::Json& id = request["id"];
+
+	Command_Request cmdRequest;
+	std::string error;
+
+	if (!Control_Parse_Submission(mDispatcher.Get_Terminal(), mMaxBatchCommands, Command_Priority::Normal, request, cmdRequest, error)) {
+		Send(*conn, json11::Json::object{ { "event", "error" }, { "id", id }, { "error", error } });
+		return;
+	}
+
+	// holding the write lock until the ticket is sent keeps the "submitted" reply ahead of the result
+	std::unique_lock<std::mutex> lck(conn->writeMtx);
+
+	const uint64_t ticket = mDispatcher.Submit(std::move(cmdRequest), [conn, id](const Command_Result& result) {
+		json11::Json::object reply = Control_Result_Json(result);
+		reply["event"] = "result";
+		reply["id"] = id;
+
+		Send(*conn, reply);
+	});
+
+	if (conn->fd >= 0) {
+		Control_Write_Frame(conn->fd, json11::Json(json11::Json::object{ { "event", "submitted" }, { "id", id }, { "ticket", static_cast<double>(ticket) } }).dump());
+	}
+}
@@ -0,0 +1,119 @@
+/**
+ * @file    control_server.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains control socket server of daemon mode
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#include "command_dispatcher.h"
+
+#include "json11.hpp"
+
+/*
+ * Control socket server - keeps serving commands submitted over local Unix domain socket using one dispatcher;
+ * results are streamed back to the submitting client as soon as they arrive
+ */
+class Control_Server
+{
+	private:
+		/*
+		 * Connected client; shared with completion callbacks, so late results of disconnected client are dropped
+		 */
+		struct Connection
+		{
+			// client socket; -1 when closed
+			int fd = -1;
+			// serializes writes of results from dispatcher thread and replies from client thread
+			std::mutex writeMtx;
+			// client thread
+			std::thread thread;
+			// has the client thread finished?
+			std::atomic<bool> finished{ false };
+		};
+
+		// dispatcher all commands are submitted to
+		Command_Dispatcher& mDispatcher;
+		// maximum number of commands in single batch
+		size_t mMaxBatchCommands;
+
+		// path of listening socket
+		std::string mPath;
+		// listening socket
+		int mListenFd;
+
+		// connected clients
+		std::list<std::shared_ptr<Connection>> mConnections;
+
+	protected:
+		// sends message to client; returns false if the client is gone
+		static bool Send(Connection& conn, const json11::Json& message);
+		// closes client socket
+		static void Close(Connection& conn);
+
+		// client thread routine - reads and processes requests until the client disconnects
+		void Serve(std::shared_ptr<Connection> conn);
+		// processes single request of client
+		void Process_Request(const std::shared_ptr<Connection>& conn, const json11::Json& request);
+		// encodes and submits command request of client
+		void Submit(const std::shared_ptr<Connection>& conn, const json11::Json& request);
+		// joins threads of disconnected clients
+		void Reap_Connections(bool all);
+
+	public:
+		Control_Server(Command_Dispatcher& dispatcher, size_t maxBatchCommands);
+		~Control_Server();
+
+		// creates listening socket on given path; returns false on failure
+		bool Open(const std::string& path);
+		// serves clients until SIGINT or SIGTERM is received
+		int Run();
+		// closes listening socket and all client connections
+		void Close();
+};
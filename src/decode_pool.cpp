@@ -0,0 +1,171 @@
+/**
+ * @file    decode_pool.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of pool of uplink decoding threads
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "decode_pool.h"
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+
+// default maximum number of decoding threads; decoding is cheap, more threads would mostly wait
+static const size_t Default_Max_Threads = 4;
+
+Decode_Pool::Decode_Pool()
+	: mStop(false), mRunning(false)
+{
+	//
+}
+
+Decode_Pool::~Decode_Pool()
+{
+	Stop();
+}
+
+void Decode_Pool::Start(size_t threadCount, Handler handler)
+{
+	Stop();
+
+	if (threadCount == 0) {
+		threadCount = std::min<size_t>(Default_Max_Threads, std::max(1u, std::thread::hardware_concurrency()));
+	}
+
+	mHandler = std::move(handler);
+	mStop = false;
+
+	for (size_t i = 0; i < threadCount; i++) {
+		mWorkers.emplace_back(new Worker());
+	}
+
+	for (auto& worker : mWorkers) {
+		Worker* w = worker.get();
+		w->thread = std::thread([this, w]() { Worker_Loop(*w); });
+	}
+
+	mRunning = true;
+}
+
+void Decode_Pool::Stop()
+{
+	if (mWorkers.empty()) {
+		return;
+	}
+
+	mRunning = false;
+	mStop = true;
+
+	for (auto& worker : mWorkers) {
+		{
+			std::unique_lock<std::mutex> lck(worker->mtx);
+		}
+		worker->cv.notify_one();
+		worker->thread.join();
+	}
+
+	mWorkers.clear();
+}
+
+bool Decode_Pool::Is_Running() const
+{
+	return mRunning;
+}
+
+bool Decode_Pool::Submit(std::string&& node, std::string&& payload)
+{
+	if (!mRunning) {
+		return false;
+	}
+
+	Worker& worker = *mWorkers[std::hash<std::string>()(node) % mWorkers.size()];
+
+	Raw_Uplink uplink{ std::move(node), std::move(payload) };
+
+	// full queue slows the submitting thread down, so the backlog stays at the broker
+	while (!worker.queue.Try_Push(std::move(uplink))) {
+		std::this_thread::yield();
+	}
+
+	// pairs with the fence in Worker_Loop, so either the worker sees the message, or we see it sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (worker.sleeping.load(std::memory_order_relaxed)) {
+		{
+			std::unique_lock<std::mutex> lck(worker.mtx);
+		}
+		worker.cv.notify_one();
+	}
+
+	return true;
+}
+
+void Decode_Pool::Worker_Loop(Worker& worker)
+{
+	Raw_Uplink uplink;
+
+	Trace_Recorder::Set_Thread_Name("decode");
+
+	while (true) {
+		if (worker.queue.Try_Pop(uplink)) {
+			Trace_Span span("Decode uplink");
+
+			mHandler(uplink.node, uplink.payload);
+			continue;
+		}
+
+		if (mStop) {
+			return;
+		}
+
+		worker.sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		{
+			std::unique_lock<std::mutex> lck(worker.mtx);
+
+			// the timeout is just a safety net, every submit to sleeping worker notifies it
+			worker.cv.wait_for(lck, std::chrono::milliseconds(100), [&]() { return !worker.queue.Empty() || mStop; });
+		}
+
+		worker.sleeping.store(false, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,130 @@
+/**
+ * @file    decode_pool.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains pool of uplink decoding threads
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "spsc_queue.h"
+
+/*
+ * Raw uplink message waiting for decoding
+ */
+struct Raw_Uplink
+{
+	// node the message belongs to (as resolved from topic)
+	std::string node;
+	// raw message payload
+	std::string payload;
+};
+
+/*
+ * Pool of threads decoding raw uplink messages; messages of one node are always decoded by the same thread,
+ * so they keep their order
+ */
+class Decode_Pool final
+{
+	public:
+		// decodes single message
+		using Handler = std::function<void(const std::string& node, const std::string& payload)>;
+
+		// number of messages each thread could have waiting
+		static constexpr size_t Queue_Capacity = 1024;
+
+	private:
+		/*
+		 * Single decoding thread and its queue
+		 */
+		struct Worker
+		{
+			// messages waiting for this worker; the only producer is the submitting thread
+			Spsc_Queue<Raw_Uplink> queue{ Queue_Capacity };
+			// worker thread
+			std::thread thread;
+			// guards sleeping worker wakeup
+			std::mutex mtx;
+			// signalled when message is submitted to sleeping worker
+			std::condition_variable cv;
+			// is the worker going to sleep (or sleeping)?
+			std::atomic<bool> sleeping{ false };
+		};
+
+		// decoding threads
+		std::vector<std::unique_ptr<Worker>> mWorkers;
+		// message decoder
+		Handler mHandler;
+		// asks workers to decode remaining messages and end
+		std::atomic<bool> mStop;
+		// are the workers running? read by the submitting thread, while the owner starts and stops the pool
+		std::atomic<bool> mRunning;
+
+	protected:
+		// worker thread body
+		void Worker_Loop(Worker& worker);
+
+	public:
+		Decode_Pool();
+		Decode_Pool(const Decode_Pool&) = delete;
+		Decode_Pool& operator=(const Decode_Pool&) = delete;
+		~Decode_Pool();
+
+		// starts given number of threads (0 = by CPU count, at most 4) decoding messages by handler
+		void Start(size_t threadCount, Handler handler);
+		// decodes remaining messages and stops all threads
+		void Stop();
+
+		// is the pool running?
+		bool Is_Running() const;
+
+		// hands message over to the thread of its node; must be always called from the same thread, and never concurrently with Stop;
+		// blocks only if the thread queue is full; returns false if the pool is not running
+		bool Submit(std::string&& node, std::string&& payload);
+};
@@ -0,0 +1,191 @@
+/**
+ * @file    duty_cycle_limiter.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of duty-cycle limiter of downlinks
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "duty_cycle_limiter.h"
+
+Airtime_Bucket::Airtime_Bucket(double rate, double capacity, std::chrono::steady_clock::time_point now)
+	: mRate(rate), mCapacity(capacity), mTokens(capacity), mConsumed(0), mLastRefill(now)
+{
+	//
+}
+
+void Airtime_Bucket::Refill(std::chrono::steady_clock::time_point now)
+{
+	if (now <= mLastRefill) {
+		return;
+	}
+
+	const double elapsedMs = std::chrono::duration<double, std::milli>(now - mLastRefill).count();
+
+	mTokens = std::min(mCapacity, mTokens + elapsedMs * mRate);
+	mLastRefill = now;
+}
+
+long Airtime_Bucket::Get_Wait_Ms(double airtimeMs) const
+{
+	if (mTokens >= airtimeMs) {
+		return 0;
+	}
+
+	// downlink longer than whole bucket would never be released, let it wait for full bucket
+	const double missing = std::min(airtimeMs, mCapacity) - mTokens;
+	if (missing <= 0) {
+		return 0;
+	}
+
+	return static_cast<long>(std::ceil(missing / mRate));
+}
+
+void Airtime_Bucket::Consume(double airtimeMs)
+{
+	mTokens = std::max(0.0, mTokens - airtimeMs);
+	mConsumed += airtimeMs;
+}
+
+double Airtime_Bucket::Get_Tokens() const
+{
+	return mTokens;
+}
+
+double Airtime_Bucket::Get_Capacity() const
+{
+	return mCapacity;
+}
+
+double Airtime_Bucket::Get_Consumed() const
+{
+	return mConsumed;
+}
+
+Duty_Cycle_Limiter::Duty_Cycle_Limiter(const Duty_Cycle_Settings& settings)
+	: mSettings(settings)
+{
+	//
+}
+
+bool Duty_Cycle_Limiter::Is_Enabled() const
+{
+	return (mSettings.gatewayPercent > 0) || (mSettings.nodePercent > 0);
+}
+
+double Duty_Cycle_Limiter::Get_Downlink_Airtime(size_t packetLen) const
+{
+	return LoRaWAN_Time_On_Air_Ms(mSettings.radio, packetLen);
+}
+
+Airtime_Bucket& Duty_Cycle_Limiter::Get_Bucket(std::map<std::string, Airtime_Bucket>& buckets, const std::string& key, double percent, std::chrono::steady_clock::time_point now)
+{
+	auto itr = buckets.find(key);
+	if (itr == buckets.end()) {
+		const double rate = percent / 100.0;
+		itr = buckets.emplace(key, Airtime_Bucket(rate, rate * mSettings.windowSecs * 1000.0, now)).first;
+	}
+
+	itr->second.Refill(now);
+
+	return itr->second;
+}
+
+long Duty_Cycle_Limiter::Acquire(const std::string& gateway, const std::string& node, double airtimeMs, std::chrono::steady_clock::time_point now)
+{
+	Airtime_Bucket* gatewayBucket = nullptr;
+	Airtime_Bucket* nodeBucket = nullptr;
+	long waitMs = 0;
+
+	if (mSettings.gatewayPercent > 0) {
+		gatewayBucket = &Get_Bucket(mGateways, gateway, mSettings.gatewayPercent, now);
+		waitMs = std::max(waitMs, gatewayBucket->Get_Wait_Ms(airtimeMs));
+	}
+
+	if (mSettings.nodePercent > 0) {
+		nodeBucket = &Get_Bucket(mNodes, node, mSettings.nodePercent, now);
+		waitMs = std::max(waitMs, nodeBucket->Get_Wait_Ms(airtimeMs));
+	}
+
+	// nothing is consumed unless both budgets allow the downlink
+	if (waitMs > 0) {
+		return waitMs;
+	}
+
+	if (gatewayBucket != nullptr) {
+		gatewayBucket->Consume(airtimeMs);
+	}
+	if (nodeBucket != nullptr) {
+		nodeBucket->Consume(airtimeMs);
+	}
+
+	return 0;
+}
+
+std::vector<Duty_Cycle_Usage> Duty_Cycle_Limiter::Get_Usage(std::chrono::steady_clock::time_point now, bool includeNodes)
+{
+	std::vector<Duty_Cycle_Usage> usage;
+
+	for (auto& bucketPair : mGateways) {
+		bucketPair.second.Refill(now);
+		usage.push_back({ "gateway", bucketPair.first, bucketPair.second.Get_Consumed(), bucketPair.second.Get_Tokens(), bucketPair.second.Get_Capacity() });
+	}
+
+	if (includeNodes) {
+		for (auto& bucketPair : mNodes) {
+			bucketPair.second.Refill(now);
+			usage.push_back({ "node", bucketPair.first, bucketPair.second.Get_Consumed(), bucketPair.second.Get_Tokens(), bucketPair.second.Get_Capacity() });
+		}
+	}
+
+	return usage;
+}
+
+void Duty_Cycle_Limiter::Print_Usage(const std::vector<Duty_Cycle_Usage>& usage, std::ostream& output)
+{
+	for (const Duty_Cycle_Usage& budget : usage) {
+		const double inUse = (budget.capacityMs > 0) ? 100.0 * (budget.capacityMs - budget.availableMs) / budget.capacityMs : 0.0;
+
+		output << "Airtime of " << budget.scope << " " << (budget.id.empty() ? "(any)" : budget.id) << ": " << (budget.consumedMs / 1000.0) << " s consumed, "
+			<< inUse << " % of " << (budget.capacityMs / 1000.0) << " s budget in use" << std::endl;
+	}
+}
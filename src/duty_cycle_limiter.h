@@ -0,0 +1,148 @@
+/**
+ * @file    duty_cycle_limiter.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains duty-cycle limiter of downlinks
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+#include "lora_airtime.h"
+
+/*
+ * Duty-cycle limits of downlinks
+ */
+struct Duty_Cycle_Settings
+{
+	double gatewayPercent = 0;			// airtime budget of single gateway (or whole region, when gateway is unknown) in %; 0 = unlimited
+	double nodePercent = 0;				// airtime budget of downlinks to single node in %; 0 = unlimited
+	long windowSecs = 3600;				// observation window; the bucket holds budget of one window
+	Lora_Radio_Settings radio;			// radio settings of downlinks
+};
+
+/*
+ * Usage of single airtime budget
+ */
+struct Duty_Cycle_Usage
+{
+	// "gateway" or "node"
+	std::string scope;
+	// gateway or node identifier; empty gateway means the whole region
+	std::string id;
+	// total airtime consumed in ms
+	double consumedMs;
+	// airtime currently available in ms
+	double availableMs;
+	// airtime of full bucket in ms
+	double capacityMs;
+};
+
+/*
+ * Token bucket of airtime - refills with rate given by duty cycle up to budget of one observation window
+ */
+class Airtime_Bucket
+{
+	private:
+		// refill rate in airtime ms per ms
+		double mRate;
+		// bucket capacity in airtime ms
+		double mCapacity;
+		// airtime available in ms
+		double mTokens;
+		// total airtime consumed in ms
+		double mConsumed;
+		// last refill time
+		std::chrono::steady_clock::time_point mLastRefill;
+
+	public:
+		Airtime_Bucket(double rate, double capacity, std::chrono::steady_clock::time_point now);
+
+		// refills the bucket with airtime accumulated since last refill
+		void Refill(std::chrono::steady_clock::time_point now);
+		// retrieves time in ms until given airtime is available (0 if available now)
+		long Get_Wait_Ms(double airtimeMs) const;
+		// consumes given airtime
+		void Consume(double airtimeMs);
+
+		double Get_Tokens() const;
+		double Get_Capacity() const;
+		double Get_Consumed() const;
+};
+
+/*
+ * Duty-cycle limiter - keeps airtime budget per gateway and per node; downlink is released only if both
+ * budgets allow it, so downlinks are sent at the highest rate allowed
+ */
+class Duty_Cycle_Limiter
+{
+	private:
+		// limiter settings
+		Duty_Cycle_Settings mSettings;
+		// budgets of gateways
+		std::map<std::string, Airtime_Bucket> mGateways;
+		// budgets of nodes
+		std::map<std::string, Airtime_Bucket> mNodes;
+
+	protected:
+		// retrieves bucket for given key, creates full one when needed
+		Airtime_Bucket& Get_Bucket(std::map<std::string, Airtime_Bucket>& buckets, const std::string& key, double percent, std::chrono::steady_clock::time_point now);
+
+	public:
+		Duty_Cycle_Limiter(const Duty_Cycle_Settings& settings = {});
+
+		// is any limit set?
+		bool Is_Enabled() const;
+		// estimates airtime of downlink with given packet length in ms
+		double Get_Downlink_Airtime(size_t packetLen) const;
+
+		// reserves airtime of downlink through given gateway to given node; returns 0 on success, otherwise time in ms until the downlink could be released
+		long Acquire(const std::string& gateway, const std::string& node, double airtimeMs, std::chrono::steady_clock::time_point now);
+		// retrieves usage of all gateway budgets, and node budgets if requested
+		std::vector<Duty_Cycle_Usage> Get_Usage(std::chrono::steady_clock::time_point now, bool includeNodes);
+
+		// prints usage of budgets in human-readable form
+		static void Print_Usage(const std::vector<Duty_Cycle_Usage>& usage, std::ostream& output);
+};
@@ -0,0 +1,357 @@
+/**
+ * @file    fleet_runner.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of fan-out execution of script on many nodes
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+
+#include "fleet_runner.h"
+
+// checks and normalizes node DevEUI; returns false if it is not 16 hex digits
+static bool Normalize_DevEUI(std::string& devEui)
+{
+	if (devEui.length() != 16) {
+		return false;
+	}
+
+	for (char& c : devEui) {
+		if (!std::isxdigit(static_cast<unsigned char>(c))) {
+			return false;
+		}
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	return true;
+}
+
+Fleet_Runner::Fleet_Runner(Command_Dispatcher& dispatcher, Output_Sink& output)
+	: mDispatcher(dispatcher), mOutput(output)
+{
+	//
+}
+
+bool Fleet_Runner::Load_Targets(const std::string& spec, std::vector<Fleet_Target>& targets, std::ostream& err)
+{
+	std::vector<Fleet_Target> parsed;
+	std::set<std::string> seen;
+
+	std::ifstream targetFs(spec);
+	if (targetFs.is_open()) {
+		std::string line;
+		size_t lineNo = 0;
+
+		// file - "<deveui> [gateway]" per line
+		while (std::getline(targetFs, line)) {
+			lineNo++;
+
+			std::istringstream ss(line);
+			Fleet_Target target;
+
+			if (!(ss >> target.node) || target.node[0] == '#' || target.node[0] == ';') {
+				continue;
+			}
+			ss >> target.gateway;
+
+			if (!Normalize_DevEUI(target.node)) {
+				err << spec << ":" << lineNo << ": invalid DevEUI: " << target.node << std::endl;
+				return false;
+			}
+
+			parsed.push_back(target);
+		}
+	} else {
+		std::istringstream ss(spec);
+		std::string item;
+
+		// selector - "<deveui>[@gateway],..."
+		while (std::getline(ss, item, ',')) {
+			Fleet_Target target;
+
+			const size_t atPos = item.find('@');
+			target.node = item.substr(0, atPos);
+			if (atPos != std::string::npos) {
+				target.gateway = item.substr(atPos + 1);
+			}
+
+			if (!Normalize_DevEUI(target.node)) {
+				err << "Invalid target (not a file, nor a DevEUI): " << item << std::endl;
+				return false;
+			}
+
+			parsed.push_back(target);
+		}
+	}
+
+	// every node is targeted just once
+	targets.clear();
+	for (Fleet_Target& target : parsed) {
+		if (seen.insert(target.node).second) {
+			targets.push_back(std::move(target));
+		}
+	}
+
+	if (targets.empty()) {
+		err << "No targets given" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool Fleet_Runner::Load_Script(Terminal_Base& terminal, Line_Reader& input, size_t maxBatchCommands, std::vector<Command_Request>& script, std::ostream& err)
+{
+	Terminal_Command_Buffer cmdBuf;
+	std::vector<std::string> sources;
+	std::string line;
+	size_t lineNo = 0, batchCtr = 0, batchLine = 0;
+	bool batchMode = false;
+
+	script.clear();
+
+	auto append = [&](const std::string& description, bool expectResponse) {
+		Command_Request request;
+
+		cmdBuf.Serialize(request.packet);
+		request.commands = terminal.Get_Pending_Commands();
+		request.sources = sources;
+		request.expectResponse = expectResponse;
+		request.description = description;
+
+		script.push_back(std::move(request));
+	};
+
+	while (input.Next(line)) {
+		lineNo++;
+
+		if (line.empty()) {
+			continue;
+		}
+
+		if (line == "!batch") {
+			if (batchMode) {
+				err << "line " << lineNo << ": batch mode already started" << std::endl;
+				return false;
+			}
+
+			batchMode = true;
+			batchCtr = 0;
+			batchLine = lineNo;
+
+			cmdBuf.Reset();
+			sources.clear();
+			terminal.Start_Command_Batch(cmdBuf, 0);
+			continue;
+		} else if (line == "!commit") {
+			if (!batchMode || batchCtr == 0) {
+				err << "line " << lineNo << ": no batch to commit" << std::endl;
+				return false;
+			}
+
+			batchMode = false;
+			append("batch at line " + std::to_string(batchLine), true);
+			continue;
+		} else if (line == "!abort") {
+			if (!batchMode) {
+				err << "line " << lineNo << ": not in batch mode" << std::endl;
+				return false;
+			}
+
+			batchMode = false;
+			continue;
+		} else if (line[0] == '!') {
+			err << "line " << lineNo << ": unknown control command: " << line << std::endl;
+			return false;
+		}
+
+		Terminal_Command_Block cmdBlock;
+
+		if (batchMode) {
+			if (batchCtr >= maxBatchCommands) {
+				err << "line " << lineNo << ": maximum number of batch commands reached: " << batchCtr << std::endl;
+				return false;
+			}
+		} else {
+			cmdBuf.Reset();
+			sources.clear();
+			terminal.Start_Single_Command(cmdBuf, 0);
+		}
+
+		if (!terminal.Encode_Command(line, cmdBlock)) {
+			err << "line " << lineNo << ": unknown command: " << line << std::endl;
+			return false;
+		}
+
+		cmdBuf.Set_Flag_16bit_Module_ID(cmdBuf.Has_Flag_16bit_Module_Id() || (cmdBlock.Get_Module_ID() > 0xFF));
+		if (!cmdBuf.Append(cmdBlock)) {
+			err << "line " << lineNo << ": packet does not fit into single frame: " << line << std::endl;
+			return false;
+		}
+		sources.push_back(line);
+
+		if (batchMode) {
+			batchCtr++;
+		} else {
+			// when sending "reload", we actually have no chance to send back response
+			append(line, line != "reload");
+		}
+	}
+
+	if (batchMode) {
+		err << "line " << batchLine << ": batch not committed" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Fleet_Runner::Load_Script(const Compiled_Script& compiled, std::vector<Command_Request>& script)
+{
+	Compiled_Record record;
+
+	script.clear();
+
+	for (size_t i = 0; i < compiled.Get_Record_Count(); i++) {
+		compiled.Get_Record(i, record);
+
+		Command_Request request;
+		request.packet.assign(record.packet, record.packet + record.packetLen);
+		request.commands = record.commands;
+		request.expectResponse = !(record.flags & Compiled_Record_No_Response);
+		request.description = "line " + std::to_string(record.sourceLine);
+
+		script.push_back(std::move(request));
+	}
+}
+
+void Fleet_Runner::Submit_Next(size_t target)
+{
+	size_t next;
+
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		next = mProgress[target].next;
+	}
+
+	// the packet is shared by all nodes, just the sequence number is assigned per node
+	Command_Request request = mScript[next];
+	request.node = mTargets[target].node;
+	request.gateway = mTargets[target].gateway;
+	request.priority = Command_Priority::Bulk;
+
+	mDispatcher.Submit(std::move(request), [this, target](const Command_Result& result) { On_Completed(target, result); });
+}
+
+void Fleet_Runner::On_Completed(size_t target, const Command_Result& result)
+{
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		Node_Progress& progress = mProgress[target];
+
+		if (result.status != Command_Status::OK || !result.responseOK) {
+			progress.status = (result.status == Command_Status::OK) ? Command_Status::Failed : result.status;
+			progress.output = result.output;
+
+			Output_Record(mOutput) << mTargets[target].node << ": " << Command_Status_Name(progress.status) << " at request " << (progress.next + 1) << "/" << mScript.size()
+				<< " (" << result.description << ")\n" << result.output << '\n';
+			return;
+		}
+
+		progress.next++;
+
+		if (progress.next >= mScript.size()) {
+			progress.status = Command_Status::OK;
+
+			mOutput.Write_Line(mTargets[target].node + ": ok");
+			return;
+		}
+	}
+
+	Submit_Next(target);
+}
+
+int Fleet_Runner::Run(const std::vector<Command_Request>& script, const std::vector<Fleet_Target>& targets)
+{
+	mScript = script;
+	mTargets = targets;
+	mProgress.assign(targets.size(), Node_Progress());
+
+	const auto start = std::chrono::steady_clock::now();
+
+	Output_Record(mOutput) << "Fleet: running " << mScript.size() << " requests on " << mTargets.size() << " nodes\n";
+
+	if (!mScript.empty()) {
+		for (size_t i = 0; i < mTargets.size(); i++) {
+			Submit_Next(i);
+		}
+
+		mDispatcher.Wait_All();
+	}
+
+	size_t okCnt = 0, failedCnt = 0, timeoutCnt = 0;
+
+	for (const Node_Progress& progress : mProgress) {
+		if (mScript.empty() || progress.status == Command_Status::OK) {
+			okCnt++;
+		} else if (progress.status == Command_Status::Timeout) {
+			timeoutCnt++;
+		} else {
+			failedCnt++;
+		}
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	Output_Record summary(mOutput);
+
+	summary << "Fleet: " << okCnt << " succeeded, " << failedCnt << " failed, " << timeoutCnt << " timed out of " << mTargets.size()
+		<< " nodes in " << (elapsed / 1000.0) << " s\n";
+
+	Duty_Cycle_Limiter::Print_Usage(mDispatcher.Get_Duty_Cycle_Usage(), summary);
+
+	return (okCnt == mTargets.size()) ? 0 : 4;
+}
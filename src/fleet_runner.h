@@ -0,0 +1,120 @@
+/**
+ * @file    fleet_runner.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains fan-out execution of script on many nodes
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "command_dispatcher.h"
+#include "script_compiler.h"
+#include "output_sink.h"
+
+/*
+ * Target node of fleet run
+ */
+struct Fleet_Target
+{
+	// node DevEUI (lowercase)
+	std::string node;
+	// gateway serving the node; may be empty
+	std::string gateway;
+};
+
+/*
+ * Fleet runner - encodes script once and executes it on many nodes in parallel; every node runs the script
+ * sequentially and stops on its first failed command
+ */
+class Fleet_Runner final
+{
+	private:
+		/*
+		 * Progress and result of single node
+		 */
+		struct Node_Progress
+		{
+			// index of script request in progress
+			size_t next = 0;
+			// final state of node
+			Command_Status status = Command_Status::Pending;
+			// output of last failed command
+			std::string output;
+		};
+
+		// dispatcher of commands
+		Command_Dispatcher& mDispatcher;
+		// output sink
+		Output_Sink& mOutput;
+		// guards progress written from dispatcher thread
+		std::mutex mMtx;
+
+		// encoded script requests, without node
+		std::vector<Command_Request> mScript;
+		// targets of current run
+		std::vector<Fleet_Target> mTargets;
+		// progress of every target
+		std::vector<Node_Progress> mProgress;
+
+	protected:
+		// submits next script request of given target
+		void Submit_Next(size_t target);
+		// processes completed request of given target
+		void On_Completed(size_t target, const Command_Result& result);
+
+	public:
+		Fleet_Runner(Command_Dispatcher& dispatcher, Output_Sink& output);
+
+		// loads targets from file (one "<deveui> [gateway]" per line) or from selector ("<deveui>[@gateway],..."); returns false on invalid target
+		static bool Load_Targets(const std::string& spec, std::vector<Fleet_Target>& targets, std::ostream& err);
+
+		// encodes text script (the same syntax as interactive input) to requests; returns false on first invalid line
+		static bool Load_Script(Terminal_Base& terminal, Line_Reader& input, size_t maxBatchCommands, std::vector<Command_Request>& script, std::ostream& err);
+		// takes packets of pre-validated compiled script as requests
+		static void Load_Script(const Compiled_Script& compiled, std::vector<Command_Request>& script);
+
+		// runs the script on all targets and prints summary; returns 0 if all nodes succeeded
+		int Run(const std::vector<Command_Request>& script, const std::vector<Fleet_Target>& targets);
+};
@@ -0,0 +1,354 @@
+/**
+ * @file    frame_journal.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains memory-mapped journal of raw frames implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+#include "frame_journal.h"
+
+static_assert(sizeof(Journal_File_Header) == 32, "Unexpected journal header size");
+static_assert(sizeof(Journal_Record_Header) == 24, "Unexpected journal record header size");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Record size could not be committed atomically");
+
+static const char Journal_Magic[4] = { 'K', 'R', 'T', 'J' };
+static const char Journal_Index_Magic[4] = { 'K', 'R', 'T', 'I' };
+static const uint16_t Journal_Format_Version = 1;
+
+// retrieves size of committed record at given place; zero if not committed yet
+static uint32_t Load_Record_Size(const uint8_t* rec)
+{
+	return reinterpret_cast<const std::atomic<uint32_t>*>(rec)->load(std::memory_order_acquire);
+}
+
+// retrieves monotonic time in nanoseconds
+static uint64_t Steady_Now_Ns()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool Index_Entry_Less(const Journal_Index_Entry& a, const Journal_Index_Entry& b)
+{
+	return (a.node < b.node) || (a.node == b.node && a.timestamp < b.timestamp);
+}
+
+Frame_Journal::Frame_Journal()
+	: mWritePos(0), mDropped(0), mRunning(false), mSyncIntervalMs(1000), mScanPos(0)
+{
+	//
+}
+
+Frame_Journal::~Frame_Journal()
+{
+	Close();
+}
+
+bool Frame_Journal::Open(const Journal_Settings& settings)
+{
+	Journal_File_Header hdr;
+
+	const size_t capacity = static_cast<size_t>(settings.capacityMb) * 1024 * 1024;
+
+	if (capacity <= sizeof(hdr) || !mFile.Create(settings.file, capacity)) {
+		return false;
+	}
+
+	mPath = settings.file;
+	mSyncIntervalMs = std::max(1L, settings.syncIntervalMs);
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, Journal_Magic, sizeof(hdr.magic));
+	hdr.formatVersion = Journal_Format_Version;
+	hdr.capacity = capacity;
+	hdr.steadyBase = Steady_Now_Ns();
+	hdr.wallBase = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	memcpy(mFile.Get_Writable_Data(), &hdr, sizeof(hdr));
+
+	mWritePos = sizeof(hdr);
+	mScanPos = sizeof(hdr);
+	mDropped = 0;
+	mIndex.clear();
+
+	mRunning = true;
+	mSyncThread = std::thread(&Frame_Journal::Sync_Thread, this);
+
+	return true;
+}
+
+void Frame_Journal::Close()
+{
+	if (!mSyncThread.joinable()) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mSyncMtx);
+		mRunning = false;
+		mSyncCv.notify_all();
+	}
+
+	mSyncThread.join();
+
+	Scan_Committed();
+	mFile.Sync(false);
+
+	// side index is sorted, so the reader could binary search by node and time
+	std::sort(mIndex.begin(), mIndex.end(), Index_Entry_Less);
+
+	std::ofstream idxFs(mPath + ".idx", std::ios::binary | std::ios::trunc);
+	if (idxFs.is_open()) {
+		const uint32_t count = static_cast<uint32_t>(mIndex.size());
+
+		idxFs.write(Journal_Index_Magic, sizeof(Journal_Index_Magic));
+		idxFs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		idxFs.write(reinterpret_cast<const char*>(mIndex.data()), mIndex.size() * sizeof(Journal_Index_Entry));
+	}
+
+	if (mDropped > 0) {
+		std::cerr << "Journal full, " << mDropped << " frames were not journaled" << std::endl;
+	}
+
+	mFile.Close();
+}
+
+void Frame_Journal::Sync_Thread()
+{
+	std::unique_lock<std::mutex> lck(mSyncMtx);
+
+	while (mRunning) {
+		mSyncCv.wait_for(lck, std::chrono::milliseconds(mSyncIntervalMs));
+
+		Scan_Committed();
+		mFile.Sync(true);
+	}
+}
+
+void Frame_Journal::Scan_Committed()
+{
+	Journal_Record_Header hdr;
+	const uint8_t* data = mFile.Get_Data();
+	const size_t capacity = mFile.Get_Size();
+
+	// stop on first record not committed yet; it will be indexed on next scan
+	while (mScanPos + sizeof(hdr) <= capacity) {
+
+		const uint32_t size = Load_Record_Size(data + mScanPos);
+		if (size == 0) {
+			break;
+		}
+
+		memcpy(&hdr, data + mScanPos, sizeof(hdr));
+
+		mIndex.push_back({ hdr.node, hdr.timestamp, mScanPos });
+		mScanPos += size;
+	}
+}
+
+void Frame_Journal::Record(Journal_Direction direction, uint64_t node, uint8_t seq, const uint8_t* frame, size_t frameLen)
+{
+	Journal_Record_Header hdr;
+
+	if (!mFile.Get_Data() || frameLen > 0xFFFF) {
+		return;
+	}
+
+	const size_t recSize = (sizeof(hdr) + frameLen + 7) & ~static_cast<size_t>(7);
+
+	// reserve space; every thread then writes to its own region
+	const size_t offset = mWritePos.fetch_add(recSize, std::memory_order_relaxed);
+	if (offset + recSize > mFile.Get_Size()) {
+		mDropped++;
+		return;
+	}
+
+	uint8_t* dst = mFile.Get_Writable_Data() + offset;
+
+	hdr.size = 0;
+	hdr.direction = static_cast<uint8_t>(direction);
+	hdr.seq = seq;
+	hdr.frameLen = static_cast<uint16_t>(frameLen);
+	hdr.node = node;
+	hdr.timestamp = Steady_Now_Ns();
+
+	memcpy(dst, &hdr, sizeof(hdr));
+	memcpy(dst + sizeof(hdr), frame, frameLen);
+
+	// commit the record by publishing its size
+	reinterpret_cast<std::atomic<uint32_t>*>(dst)->store(static_cast<uint32_t>(recSize), std::memory_order_release);
+}
+
+uint64_t Frame_Journal::Node_Id(const std::string& devEui)
+{
+	uint64_t id = 0;
+
+	if (devEui.empty() || devEui.length() > 16) {
+		return 0;
+	}
+
+	for (char c : devEui) {
+		id <<= 4;
+
+		if (c >= '0' && c <= '9') {
+			id |= static_cast<uint64_t>(c - '0');
+		} else if (c >= 'a' && c <= 'f') {
+			id |= static_cast<uint64_t>(c - 'a' + 10);
+		} else if (c >= 'A' && c <= 'F') {
+			id |= static_cast<uint64_t>(c - 'A' + 10);
+		} else {
+			return 0;
+		}
+	}
+
+	return id;
+}
+
+// prints single journal record with given number of bytes available in the file; returns false if the record is corrupt and was skipped
+static bool Dump_Record(const Journal_File_Header& fileHdr, const uint8_t* rec, size_t available, std::ostream& output)
+{
+	Journal_Record_Header hdr;
+
+	if (available < sizeof(hdr)) {
+		return false;
+	}
+
+	memcpy(&hdr, rec, sizeof(hdr));
+
+	// journal left by crash may contain torn records, the frame has to fit both the record and the file
+	if (hdr.size < sizeof(hdr) || hdr.size > available || sizeof(hdr) + hdr.frameLen > hdr.size) {
+		return false;
+	}
+
+	const uint64_t relNs = hdr.timestamp - fileHdr.steadyBase;
+
+	output << "+" << (relNs / 1000000000ULL) << "." << std::setw(6) << std::setfill('0') << ((relNs / 1000ULL) % 1000000ULL)
+		<< " " << (hdr.direction == static_cast<uint8_t>(Journal_Direction::Downlink) ? "TX" : "RX")
+		<< " node=" << std::hex << std::setw(16) << hdr.node
+		<< std::dec << " seq=" << static_cast<int>(hdr.seq) << " len=" << hdr.frameLen << " ";
+
+	for (size_t i = 0; i < hdr.frameLen; i++) {
+		output << std::hex << std::setw(2) << std::uppercase << static_cast<int>(rec[sizeof(hdr) + i]);
+	}
+
+	output << std::dec << std::nouppercase << std::setfill(' ') << std::endl;
+
+	return true;
+}
+
+bool Frame_Journal::Dump(const std::string& path, uint64_t node, uint64_t fromMs, uint64_t toMs, std::ostream& output)
+{
+	Mapped_File journal, index;
+	Journal_File_Header fileHdr;
+	Journal_Index_Entry entry;
+	Journal_Record_Header hdr;
+
+	if (!journal.Open(path) || journal.Get_Size() < sizeof(fileHdr)) {
+		return false;
+	}
+
+	memcpy(&fileHdr, journal.Get_Data(), sizeof(fileHdr));
+	if (memcmp(fileHdr.magic, Journal_Magic, sizeof(fileHdr.magic)) != 0 || fileHdr.formatVersion != Journal_Format_Version) {
+		return false;
+	}
+
+	const uint64_t fromNs = fileHdr.steadyBase + fromMs * 1000000ULL;
+	const uint64_t toNs = (toMs == 0) ? UINT64_MAX : fileHdr.steadyBase + toMs * 1000000ULL;
+
+	output << "Journal started at " << fileHdr.wallBase << " ms since epoch" << std::endl;
+
+	// use side index when filtering by node, if there is any
+	if (node != 0 && index.Open(path + ".idx") && index.Get_Size() >= 8 && memcmp(index.Get_Data(), Journal_Index_Magic, 4) == 0) {
+
+		uint32_t count;
+		memcpy(&count, index.Get_Data() + 4, sizeof(count));
+
+		if (8 + static_cast<size_t>(count) * sizeof(Journal_Index_Entry) <= index.Get_Size()) {
+
+			// entries are sorted by node and timestamp - binary search for the first one
+			size_t lo = 0, hi = count;
+			while (lo < hi) {
+				const size_t mid = (lo + hi) / 2;
+				memcpy(&entry, index.Get_Data() + 8 + mid * sizeof(entry), sizeof(entry));
+
+				if (entry.node < node || (entry.node == node && entry.timestamp < fromNs)) {
+					lo = mid + 1;
+				} else {
+					hi = mid;
+				}
+			}
+
+			for (; lo < count; lo++) {
+				memcpy(&entry, index.Get_Data() + 8 + lo * sizeof(entry), sizeof(entry));
+
+				if (entry.node != node || entry.timestamp > toNs) {
+					break;
+				}
+				// index may be out of date with the journal, corrupt records are skipped
+				if (entry.offset >= sizeof(fileHdr) && entry.offset < journal.Get_Size()) {
+					Dump_Record(fileHdr, journal.Get_Data() + entry.offset, journal.Get_Size() - static_cast<size_t>(entry.offset), output);
+				}
+			}
+
+			return true;
+		}
+	}
+
+	// no index - scan the whole journal
+	for (size_t pos = sizeof(fileHdr); pos + sizeof(hdr) <= journal.Get_Size(); pos += hdr.size) {
+
+		memcpy(&hdr, journal.Get_Data() + pos, sizeof(hdr));
+
+		if (hdr.size < sizeof(hdr) || pos + hdr.size > journal.Get_Size()) {
+			break;
+		}
+
+		if ((node == 0 || hdr.node == node) && hdr.timestamp >= fromNs && hdr.timestamp <= toNs) {
+			Dump_Record(fileHdr, journal.Get_Data() + pos, journal.Get_Size() - pos, output);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file    frame_journal.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains memory-mapped journal of raw frames
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+
+#include "mapped_file.h"
+
+/*
+ * Container of journal settings
+ */
+struct Journal_Settings
+{
+	std::string file;					// journal file path; journal disabled if empty
+	long capacityMb;					// journal file capacity in MiB
+	long syncIntervalMs;				// interval of background flushing to disk
+};
+
+/*
+ * Direction of journaled frame
+ */
+enum class Journal_Direction : uint8_t
+{
+	Downlink = 0,						// serialized packet sent to node
+	Uplink = 1,							// decoded frame received from node
+};
+
+/*
+ * Journal file header
+ */
+struct Journal_File_Header
+{
+	char magic[4];						// always "KRTJ"
+	uint16_t formatVersion;				// version of this file format
+	uint16_t reserved;					// reserved, zero
+	uint64_t capacity;					// file capacity in bytes
+	uint64_t steadyBase;				// monotonic timestamp (ns) of journal start
+	int64_t wallBase;					// wall clock time (ms since epoch) of journal start
+};
+
+/*
+ * Journal record header; followed by frame bytes and padding to 8 bytes
+ */
+struct Journal_Record_Header
+{
+	uint32_t size;						// size of the whole record; written last, zero means record not committed
+	uint8_t direction;					// Journal_Direction
+	uint8_t seq;						// packet sequence number
+	uint16_t frameLen;					// frame length
+	uint64_t node;						// node DevEUI; zero if unknown
+	uint64_t timestamp;					// monotonic timestamp in ns
+};
+
+/*
+ * Side index entry; index file is sorted by node and timestamp
+ */
+struct Journal_Index_Entry
+{
+	uint64_t node;						// node DevEUI
+	uint64_t timestamp;					// monotonic timestamp in ns
+	uint64_t offset;					// record offset within journal file
+};
+
+/*
+ * Append-only memory-mapped journal of all frames sent and received
+ */
+class Frame_Journal
+{
+	private:
+		// mapped journal file
+		Mapped_File mFile;
+		// journal file path
+		std::string mPath;
+		// position of next record; records are reserved by atomic increment, no locking needed
+		std::atomic<size_t> mWritePos;
+		// number of records not written due to full journal
+		std::atomic<size_t> mDropped;
+
+		// background thread flushing journal and building index
+		std::thread mSyncThread;
+		// mutex guarding background thread wakeups
+		std::mutex mSyncMtx;
+		// condition variable for background thread stopping
+		std::condition_variable mSyncCv;
+		// is the background thread supposed to run?
+		bool mRunning;
+		// interval of background flushing
+		long mSyncIntervalMs;
+
+		// position of the first record not indexed yet; touched only by background thread
+		size_t mScanPos;
+		// index entries collected so far; touched only by background thread
+		std::vector<Journal_Index_Entry> mIndex;
+
+	protected:
+		// background thread routine
+		void Sync_Thread();
+		// indexes all records committed since last scan
+		void Scan_Committed();
+
+	public:
+		Frame_Journal();
+		Frame_Journal(const Frame_Journal&) = delete;
+		Frame_Journal& operator=(const Frame_Journal&) = delete;
+		virtual ~Frame_Journal();
+
+		// creates journal file and starts background flushing; returns false on failure
+		bool Open(const Journal_Settings& settings);
+		// stops background flushing, writes side index and closes the journal
+		void Close();
+
+		// appends a frame to journal; safe to call from any thread
+		void Record(Journal_Direction direction, uint64_t node, uint8_t seq, const uint8_t* frame, size_t frameLen);
+
+		// converts DevEUI hex string to node identifier; zero if not valid
+		static uint64_t Node_Id(const std::string& devEui);
+
+		// prints journal contents matching given filters (node 0 = all nodes); returns false if journal could not be read
+		static bool Dump(const std::string& path, uint64_t node, uint64_t fromMs, uint64_t toMs, std::ostream& output);
+};
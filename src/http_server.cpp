@@ -0,0 +1,623 @@
+/**
+ * @file    http_server.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of embedded HTTP server
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "http_server.h"
+#include "control_protocol.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// maximum size of request headers
+constexpr size_t Max_Header_Size = 16 * 1024;
+// maximum size of request body
+constexpr size_t Max_Body_Size = 4 * 1024 * 1024;
+// how often the accept loop checks for stop request
+constexpr int Accept_Poll_Ms = 500;
+
+static const char* Status_Text(int status)
+{
+	switch (status) {
+		case 200:
+			return "OK";
+		case 202:
+			return "Accepted";
+		case 400:
+			return "Bad Request";
+		case 404:
+			return "Not Found";
+		case 405:
+			return "Method Not Allowed";
+		case 413:
+			return "Payload Too Large";
+	}
+
+	return "Error";
+}
+
+HTTP_Server::HTTP_Server(Command_Dispatcher& dispatcher, const HTTP_Settings& settings, size_t maxBatchCommands)
+	: mDispatcher(dispatcher), mSettings(settings), mMaxBatchCommands(maxBatchCommands), mListenFd(-1), mRunning(false), mLastJob(0), mPendingResults(0)
+{
+	//
+}
+
+HTTP_Server::~HTTP_Server()
+{
+	Stop();
+}
+
+#ifndef _WIN32
+
+static bool Send_All(int fd, const std::string& data)
+{
+	size_t pos = 0;
+
+	while (pos < data.size()) {
+		const ssize_t written = send(fd, data.data() + pos, data.size() - pos, MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return false;
+		}
+
+		pos += static_cast<size_t>(written);
+	}
+
+	return true;
+}
+
+bool HTTP_Server::Start()
+{
+	sockaddr_in addr{};
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(mSettings.port);
+
+	if (inet_pton(AF_INET, mSettings.bind.c_str(), &addr.sin_addr) != 1) {
+		std::cerr << "Invalid HTTP bind address: " << mSettings.bind << std::endl;
+		return false;
+	}
+
+	mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+	if (mListenFd < 0) {
+		std::cerr << "Could not create HTTP socket" << std::endl;
+		return false;
+	}
+
+	const int reuse = 1;
+	setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(mListenFd, 16) != 0) {
+		std::cerr << "Could not listen on HTTP address " << mSettings.bind << ":" << mSettings.port << std::endl;
+		close(mListenFd);
+		mListenFd = -1;
+		return false;
+	}
+
+	std::cout << "Listening for HTTP requests on " << mSettings.bind << ":" << mSettings.port << std::endl;
+
+	mRunning = true;
+	mAcceptThread = std::thread(&HTTP_Server::Accept_Loop, this);
+
+	return true;
+}
+
+void HTTP_Server::Stop()
+{
+	if (!mRunning) {
+		return;
+	}
+
+	mRunning = false;
+
+	if (mAcceptThread.joinable()) {
+		mAcceptThread.join();
+	}
+
+	close(mListenFd);
+	mListenFd = -1;
+
+	{
+		std::unique_lock<std::mutex> lck(mConnMtx);
+
+		// wakes up connections blocked in reading
+		for (auto& conn : mConnections) {
+			if (conn->fd >= 0) {
+				shutdown(conn->fd, SHUT_RDWR);
+			}
+		}
+	}
+
+	// wakes up connections streaming results
+	{
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+		mJobs_Cv.notify_all();
+	}
+
+	// no new connections are accepted, so the list could be walked without lock
+	for (auto& conn : mConnections) {
+		conn->thread.join();
+	}
+	mConnections.clear();
+
+	// the dispatcher outlives this server, so it must not complete job commands afterwards
+	Cancel_All_Jobs();
+}
+
+void HTTP_Server::Accept_Loop()
+{
+	while (mRunning) {
+		pollfd pfd{ mListenFd, POLLIN, 0 };
+
+		if (poll(&pfd, 1, Accept_Poll_Ms) <= 0 || !(pfd.revents & POLLIN)) {
+			continue;
+		}
+
+		const int fd = accept(mListenFd, nullptr, nullptr);
+		if (fd < 0) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lck(mConnMtx);
+
+		std::shared_ptr<Connection> conn = std::make_shared<Connection>();
+		conn->fd = fd;
+		conn->thread = std::thread(&HTTP_Server::Serve, this, conn);
+
+		mConnections.push_back(conn);
+
+		// join threads of connections already served
+		for (auto itr = mConnections.begin(); itr != mConnections.end(); ) {
+			if ((*itr)->finished) {
+				(*itr)->thread.join();
+				itr = mConnections.erase(itr);
+			} else {
+				++itr;
+			}
+		}
+	}
+}
+
+void HTTP_Server::Serve(std::shared_ptr<Connection> conn)
+{
+	const int fd = conn->fd;
+
+	Request request;
+
+	if (Read_Request(fd, request)) {
+		const std::string jobsPrefix = "/jobs/";
+
+		if (request.path == "/jobs") {
+			if (request.method == "POST") {
+				Create_Job(fd, request);
+			} else {
+				Respond(fd, 405, json11::Json::object{ { "error", "method not allowed" } });
+			}
+		} else if (request.path.compare(0, jobsPrefix.size(), jobsPrefix) == 0) {
+			char* end;
+			const uint64_t jobId = std::strtoull(request.path.c_str() + jobsPrefix.size(), &end, 10);
+			const std::string suffix = end;
+
+			if (request.method == "GET" && suffix.empty()) {
+				Stream_Job(fd, jobId);
+			} else if (request.method == "GET" && suffix == "/status") {
+				Get_Job_Status(fd, jobId);
+			} else if (request.method == "DELETE" && suffix.empty()) {
+				Cancel_Job(fd, jobId);
+			} else {
+				Respond(fd, 404, json11::Json::object{ { "error", "not found" } });
+			}
+		} else {
+			Respond(fd, 404, json11::Json::object{ { "error", "not found" } });
+		}
+	}
+
+	std::unique_lock<std::mutex> lck(mConnMtx);
+
+	close(fd);
+	conn->fd = -1;
+	conn->finished = true;
+}
+
+bool HTTP_Server::Read_Request(int fd, Request& request)
+{
+	std::string data;
+	char buf[4096];
+	size_t headerEnd;
+
+	while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+		if (data.size() > Max_Header_Size) {
+			Respond(fd, 413, json11::Json::object{ { "error", "request headers too large" } });
+			return false;
+		}
+
+		const ssize_t rd = recv(fd, buf, sizeof(buf), 0);
+		if (rd <= 0) {
+			return false;
+		}
+
+		data.append(buf, static_cast<size_t>(rd));
+	}
+
+	std::istringstream headers(data.substr(0, headerEnd));
+	std::string line, version;
+
+	std::getline(headers, line);
+	std::istringstream requestLine(line);
+	requestLine >> request.method >> request.path >> version;
+
+	// query string is not used by any endpoint
+	const size_t queryPos = request.path.find('?');
+	if (queryPos != std::string::npos) {
+		request.path.erase(queryPos);
+	}
+
+	size_t contentLength = 0;
+
+	while (std::getline(headers, line)) {
+		const size_t colon = line.find(':');
+		if (colon == std::string::npos) {
+			continue;
+		}
+
+		std::string name = line.substr(0, colon);
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+		if (name == "content-length") {
+			contentLength = static_cast<size_t>(std::strtoull(line.c_str() + colon + 1, nullptr, 10));
+		}
+	}
+
+	if (contentLength > Max_Body_Size) {
+		Respond(fd, 413, json11::Json::object{ { "error", "request body too large" } });
+		return false;
+	}
+
+	request.body = data.substr(headerEnd + 4);
+
+	while (request.body.size() < contentLength) {
+		const ssize_t rd = recv(fd, buf, std::min(sizeof(buf), contentLength - request.body.size()), 0);
+		if (rd <= 0) {
+			return false;
+		}
+
+		request.body.append(buf, static_cast<size_t>(rd));
+	}
+
+	request.body.resize(contentLength);
+
+	return !request.method.empty() && !request.path.empty();
+}
+
+void HTTP_Server::Respond(int fd, int status, const json11::Json& body)
+{
+	const std::string content = body.dump() + "\n";
+
+	std::ostringstream response;
+	response << "HTTP/1.1 " << status << " " << Status_Text(status) << "\r\n"
+		<< "Content-Type: application/json\r\n"
+		<< "Content-Length: " << content.size() << "\r\n"
+		<< "Connection: close\r\n\r\n"
+		<< content;
+
+	Send_All(fd, response.str());
+}
+
+bool HTTP_Server::Send_Chunk(int fd, const std::string& data)
+{
+	std::ostringstream chunk;
+	chunk << std::hex << data.size() << "\r\n" << data << "\r\n";
+
+	return Send_All(fd, chunk.str());
+}
+
+#else
+
+bool HTTP_Server::Start()
+{
+	std::cerr << "HTTP server is not supported on this platform" << std::endl;
+	return false;
+}
+
+void HTTP_Server::Stop()
+{
+	//
+}
+
+void HTTP_Server::Accept_Loop()
+{
+	//
+}
+
+void HTTP_Server::Serve(std::shared_ptr<Connection> conn)
+{
+	//
+}
+
+bool HTTP_Server::Read_Request(int fd, Request& request)
+{
+	return false;
+}
+
+void HTTP_Server::Respond(int fd, int status, const json11::Json& body)
+{
+	//
+}
+
+bool HTTP_Server::Send_Chunk(int fd, const std::string& data)
+{
+	return false;
+}
+
+#endif
+
+void HTTP_Server::Create_Job(int fd, const Request& request)
+{
+	std::string err;
+	const json11::Json submissions = json11::Json::parse(request.body, err);
+
+	if (!err.empty() || !submissions.is_array() || submissions.array_items().empty()) {
+		Respond(fd, 400, json11::Json::object{ { "error", "expected non-empty array of {node, commands}" } });
+		return;
+	}
+
+	// the whole job is validated before anything is submitted
+	std::vector<Command_Request> requests(submissions.array_items().size());
+
+	// jobs are bulk work unless the submission says otherwise, so they do not hold back interactive commands
+
+	for (size_t i = 0; i < requests.size(); i++) {
+		if (!Control_Parse_Submission(mDispatcher.Get_Terminal(), mMaxBatchCommands, Command_Priority::Bulk, submissions[i], requests[i], err)) {
+			Respond(fd, 400, json11::Json::object{ { "error", "item " + std::to_string(i) + ": " + err } });
+			return;
+		}
+	}
+
+	uint64_t jobId;
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->total = requests.size();
+
+	{
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+		jobId = ++mLastJob;
+		mJobs[jobId] = job;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+		mPendingResults += requests.size();
+	}
+
+	for (size_t i = 0; i < requests.size(); i++) {
+		const uint64_t ticket = mDispatcher.Submit(std::move(requests[i]), [this, jobId, i](const Command_Result& result) {
+			Add_Result(jobId, i, result);
+		});
+
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+		job->tickets.push_back(ticket);
+	}
+
+	Respond(fd, 202, json11::Json::object{ { "job", static_cast<double>(jobId) }, { "requests", static_cast<double>(requests.size()) } });
+}
+
+void HTTP_Server::Add_Result(uint64_t jobId, size_t index, const Command_Result& result)
+{
+	std::unique_lock<std::mutex> lck(mJobsMtx);
+
+	// this is the last access of the callback to this server
+	mPendingResults--;
+	mJobs_Cv.notify_all();
+
+	auto itr = mJobs.find(jobId);
+	if (itr == mJobs.end()) {
+		return;
+	}
+
+	Job& job = *itr->second;
+
+	json11::Json::object line = Control_Result_Json(result);
+	line["index"] = static_cast<double>(index);
+	line["description"] = result.description;
+
+	job.results.push_back(json11::Json(line).dump());
+
+	if (job.results.size() == job.total) {
+		mFinished.push_back(jobId);
+
+		// results of old jobs are not retrievable anymore
+		while (mFinished.size() > static_cast<size_t>(mSettings.maxJobs)) {
+			mJobs.erase(mFinished.front());
+			mFinished.pop_front();
+		}
+	}
+
+	mJobs_Cv.notify_all();
+}
+
+void HTTP_Server::Cancel_All_Jobs()
+{
+	std::vector<uint64_t> tickets;
+
+	{
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+
+		for (auto& jobPair : mJobs) {
+			tickets.insert(tickets.end(), jobPair.second->tickets.begin(), jobPair.second->tickets.end());
+		}
+	}
+
+	// completed commands are not cancelled, their callbacks are just waited for
+	for (uint64_t ticket : tickets) {
+		mDispatcher.Cancel(ticket);
+	}
+
+	std::unique_lock<std::mutex> lck(mJobsMtx);
+	mJobs_Cv.wait(lck, [this]() { return mPendingResults == 0; });
+}
+
+void HTTP_Server::Stream_Job(int fd, uint64_t jobId)
+{
+	std::unique_lock<std::mutex> lck(mJobsMtx);
+
+	auto itr = mJobs.find(jobId);
+	if (itr == mJobs.end()) {
+		lck.unlock();
+		Respond(fd, 404, json11::Json::object{ { "error", "unknown job" } });
+		return;
+	}
+
+	// the job is kept alive by this stream even when it gets dropped meanwhile
+	std::shared_ptr<Job> job = itr->second;
+
+	lck.unlock();
+
+#ifndef _WIN32
+	if (!Send_All(fd, "HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n\r\n")) {
+		return;
+	}
+
+	size_t sent = 0;
+
+	while (true) {
+		std::string lines;
+
+		lck.lock();
+		mJobs_Cv.wait(lck, [&]() { return job->results.size() > sent || !mRunning; });
+
+		for (; sent < job->results.size(); sent++) {
+			lines += job->results[sent] + "\n";
+		}
+
+		const bool finished = (sent == job->total) || !mRunning;
+		lck.unlock();
+
+		if (!lines.empty() && !Send_Chunk(fd, lines)) {
+			return;
+		}
+
+		if (finished) {
+			break;
+		}
+	}
+
+	Send_All(fd, "0\r\n\r\n");
+#endif
+}
+
+void HTTP_Server::Get_Job_Status(int fd, uint64_t jobId)
+{
+	std::unique_lock<std::mutex> lck(mJobsMtx);
+
+	auto itr = mJobs.find(jobId);
+	if (itr == mJobs.end()) {
+		lck.unlock();
+		Respond(fd, 404, json11::Json::object{ { "error", "unknown job" } });
+		return;
+	}
+
+	const Job& job = *itr->second;
+
+	json11::Json::array results;
+	for (const std::string& line : job.results) {
+		std::string err;
+		results.push_back(json11::Json::parse(line, err));
+	}
+
+	json11::Json::object status{
+		{ "job", static_cast<double>(jobId) },
+		{ "requests", static_cast<double>(job.total) },
+		{ "completed", static_cast<double>(job.results.size()) },
+		{ "results", results },
+	};
+
+	lck.unlock();
+
+	Respond(fd, 200, status);
+}
+
+void HTTP_Server::Cancel_Job(int fd, uint64_t jobId)
+{
+	std::vector<uint64_t> tickets;
+
+	{
+		std::unique_lock<std::mutex> lck(mJobsMtx);
+
+		auto itr = mJobs.find(jobId);
+		if (itr == mJobs.end()) {
+			lck.unlock();
+			Respond(fd, 404, json11::Json::object{ { "error", "unknown job" } });
+			return;
+		}
+
+		tickets = itr->second->tickets;
+	}
+
+	size_t cancelled = 0;
+
+	// cancelled commands complete with "cancelled" status, so the job still finishes
+	for (uint64_t ticket : tickets) {
+		if (mDispatcher.Cancel(ticket)) {
+			cancelled++;
+		}
+	}
+
+	Respond(fd, 200, json11::Json::object{ { "job", static_cast<double>(jobId) }, { "cancelled", static_cast<double>(cancelled) } });
+}
@@ -0,0 +1,181 @@
+/**
+ * @file    http_server.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains embedded HTTP server for batch command submission
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+#include "command_dispatcher.h"
+
+#include "json11.hpp"
+
+/*
+ * HTTP server settings
+ */
+struct HTTP_Settings
+{
+	std::string bind;					// address to listen on
+	uint16_t port;						// port to listen on; 0 = disabled
+	long maxJobs;						// maximum number of finished jobs kept for retrieval
+};
+
+/*
+ * Embedded HTTP server - accepts jobs of commands for many nodes and streams their results as JSON lines;
+ * commands are submitted to the same dispatcher as all the other commands
+ */
+class HTTP_Server
+{
+	private:
+		/*
+		 * Job - set of command requests submitted at once
+		 */
+		struct Job
+		{
+			// number of requests of job
+			size_t total = 0;
+			// tickets of requests
+			std::vector<uint64_t> tickets;
+			// results in order of completion (JSON lines)
+			std::vector<std::string> results;
+		};
+
+		/*
+		 * Client connection, served by its own thread
+		 */
+		struct Connection
+		{
+			// client socket; -1 when closed
+			int fd = -1;
+			// connection thread
+			std::thread thread;
+			// has the connection thread finished?
+			std::atomic<bool> finished{ false };
+		};
+
+		/*
+		 * Parsed HTTP request
+		 */
+		struct Request
+		{
+			std::string method;
+			std::string path;
+			std::string body;
+		};
+
+		// dispatcher all commands are submitted to
+		Command_Dispatcher& mDispatcher;
+		// server settings
+		HTTP_Settings mSettings;
+		// maximum number of commands in single batch
+		size_t mMaxBatchCommands;
+
+		// listening socket
+		int mListenFd;
+		// accepting thread
+		std::thread mAcceptThread;
+		// is the server running?
+		std::atomic<bool> mRunning;
+
+		// all jobs; job ID -> job
+		std::map<uint64_t, std::shared_ptr<Job>> mJobs;
+		// finished jobs in order of completion, oldest are dropped first
+		std::list<uint64_t> mFinished;
+		// last issued job ID
+		uint64_t mLastJob;
+		// guards jobs
+		std::mutex mJobsMtx;
+		// signalized when any job gets new result
+		std::condition_variable mJobs_Cv;
+		// number of submitted job commands, which result callback has not returned yet
+		size_t mPendingResults;
+
+		// client connections
+		std::list<std::shared_ptr<Connection>> mConnections;
+		// guards client connections
+		std::mutex mConnMtx;
+
+	protected:
+		// accepting thread routine
+		void Accept_Loop();
+		// connection thread routine - reads single request and responds
+		void Serve(std::shared_ptr<Connection> conn);
+
+		// reads HTTP request from socket; returns false on malformed request or closed connection
+		bool Read_Request(int fd, Request& request);
+		// sends complete response with JSON body
+		void Respond(int fd, int status, const json11::Json& body);
+		// sends chunk of chunked response; returns false if the client is gone
+		bool Send_Chunk(int fd, const std::string& data);
+
+		// POST /jobs - creates job from array of submissions
+		void Create_Job(int fd, const Request& request);
+		// GET /jobs/<id> - streams results of job as they arrive
+		void Stream_Job(int fd, uint64_t jobId);
+		// GET /jobs/<id>/status - retrieves progress and results collected so far
+		void Get_Job_Status(int fd, uint64_t jobId);
+		// DELETE /jobs/<id> - cancels commands of job not completed yet
+		void Cancel_Job(int fd, uint64_t jobId);
+
+		// stores result of job command; called from dispatcher thread
+		void Add_Result(uint64_t jobId, size_t index, const Command_Result& result);
+		// cancels commands of all jobs and waits until their result callbacks return, so none refers to this server afterwards
+		void Cancel_All_Jobs();
+
+	public:
+		HTTP_Server(Command_Dispatcher& dispatcher, const HTTP_Settings& settings, size_t maxBatchCommands);
+		~HTTP_Server();
+
+		// starts listening and serving in background; returns false on failure
+		bool Start();
+		// stops serving, closes all connections
+		void Stop();
+};
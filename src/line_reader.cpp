@@ -0,0 +1,344 @@
+/**
+ * @file    line_reader.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains streaming line input implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "line_reader.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+#ifdef _WIN32
+#define read _read
+#define close _close
+#define isatty _isatty
+#endif
+
+Line_Reader::Line_Reader()
+	: mPosition(0), mFd(-1), mOwnsFd(false), mEof(false), mPrefetchReady(false), mPrefetchEof(false), mPrefetchStop(false)
+{
+	//
+}
+
+Line_Reader::~Line_Reader()
+{
+	Close();
+}
+
+bool Line_Reader::Open(const std::string& path)
+{
+	Close();
+
+#ifndef _WIN32
+	struct stat st;
+
+	if (stat(path.c_str(), &st) != 0) {
+		return false;
+	}
+
+	// named pipes and character devices could not be mapped
+	if (!S_ISREG(st.st_mode)) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		Open_Descriptor(fd, true);
+		return true;
+	}
+#endif
+
+	if (!mMapping.Open(path)) {
+		return false;
+	}
+
+	mMapping.Advise_Sequential();
+
+	return true;
+}
+
+void Line_Reader::Open_Stdin()
+{
+	Close();
+
+	Open_Descriptor(0, false);
+}
+
+void Line_Reader::Open_Descriptor(int fd, bool ownsFd)
+{
+	mFd = fd;
+	mOwnsFd = ownsFd;
+
+#ifndef _WIN32
+	// interactive input is read on demand, so the prompt is not ahead of what the user typed
+	if (!isatty(mFd)) {
+		mPrefetchThread = std::thread(&Line_Reader::Prefetch_Worker, this);
+	}
+#endif
+}
+
+void Line_Reader::Close()
+{
+	if (mPrefetchThread.joinable()) {
+		{
+			std::unique_lock<std::mutex> lck(mPrefetchMtx);
+			mPrefetchStop = true;
+		}
+		mPrefetchCv.notify_all();
+		mPrefetchThread.join();
+	}
+
+	if (mFd >= 0 && mOwnsFd) {
+		close(mFd);
+	}
+
+	mMapping.Close();
+
+	mFd = -1;
+	mOwnsFd = false;
+	mPosition = 0;
+	mEof = false;
+	mChunk.clear();
+	mCarry.clear();
+	mPrefetched.clear();
+	mPrefetchReady = false;
+	mPrefetchEof = false;
+	mPrefetchStop = false;
+}
+
+bool Line_Reader::Read_Chunk(std::vector<char>& chunk, bool interruptible)
+{
+	chunk.resize(Chunk_Size);
+
+	while (true) {
+#ifndef _WIN32
+		// wait for data in short steps, so the reader could be closed before the writer closes the pipe
+		if (interruptible) {
+			struct pollfd pfd;
+			pfd.fd = mFd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+
+			const int ready = poll(&pfd, 1, 100);
+
+			{
+				std::unique_lock<std::mutex> lck(mPrefetchMtx);
+				if (mPrefetchStop) {
+					return false;
+				}
+			}
+
+			if (ready == 0 || (ready < 0 && errno == EINTR)) {
+				continue;
+			}
+		}
+#endif
+
+		const auto rd = read(mFd, chunk.data(), static_cast<unsigned int>(Chunk_Size));
+		if (rd < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (rd <= 0) {
+			chunk.clear();
+			return false;
+		}
+
+		chunk.resize(static_cast<size_t>(rd));
+		return true;
+	}
+}
+
+void Line_Reader::Prefetch_Worker()
+{
+	// filled chunk swaps places with the one already consumed, so no chunk is allocated after the first two
+	std::vector<char> buffer;
+
+	while (true) {
+		const bool hasData = Read_Chunk(buffer, true);
+
+		std::unique_lock<std::mutex> lck(mPrefetchMtx);
+
+		mPrefetchCv.wait(lck, [this]() { return !mPrefetchReady || mPrefetchStop; });
+
+		if (mPrefetchStop) {
+			return;
+		}
+
+		if (!hasData) {
+			mPrefetchEof = true;
+			mPrefetchCv.notify_all();
+			return;
+		}
+
+		mPrefetched.swap(buffer);
+		mPrefetchReady = true;
+		mPrefetchCv.notify_all();
+	}
+}
+
+bool Line_Reader::Next_Chunk()
+{
+	mPosition = 0;
+
+	if (mFd < 0) {
+		return false;
+	}
+
+	if (!mPrefetchThread.joinable()) {
+		return Read_Chunk(mChunk, false);
+	}
+
+	std::unique_lock<std::mutex> lck(mPrefetchMtx);
+
+	mPrefetchCv.wait(lck, [this]() { return mPrefetchReady || mPrefetchEof; });
+
+	if (!mPrefetchReady) {
+		mChunk.clear();
+		return false;
+	}
+
+	mChunk.swap(mPrefetched);
+	mPrefetchReady = false;
+	mPrefetchCv.notify_all();
+
+	return true;
+}
+
+bool Line_Reader::Next(Line_View& line)
+{
+	// mapped file - the line is viewed directly in mapping
+	if (mFd < 0) {
+		const char* data = reinterpret_cast<const char*>(mMapping.Get_Data());
+		const size_t size = mMapping.Get_Size();
+
+		if (data == nullptr || mPosition >= size) {
+			return false;
+		}
+
+		const char* begin = data + mPosition;
+		const char* end = static_cast<const char*>(std::memchr(begin, '\n', size - mPosition));
+		if (end == nullptr) {
+			end = data + size;
+		}
+
+		line.data = begin;
+		line.length = static_cast<size_t>(end - begin);
+		mPosition += line.length + 1;
+
+		return true;
+	}
+
+	if (mEof) {
+		return false;
+	}
+
+	bool carried = false;
+	mCarry.clear();
+
+	while (true) {
+		if (mPosition >= mChunk.size() && !Next_Chunk()) {
+			mEof = true;
+
+			// last line without terminator
+			if (carried) {
+				line.data = mCarry.data();
+				line.length = mCarry.length();
+				return true;
+			}
+
+			return false;
+		}
+
+		const char* begin = mChunk.data() + mPosition;
+		const size_t remaining = mChunk.size() - mPosition;
+		const char* end = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+
+		if (end == nullptr) {
+			mCarry.append(begin, remaining);
+			mPosition = mChunk.size();
+			carried = true;
+			continue;
+		}
+
+		const size_t length = static_cast<size_t>(end - begin);
+		mPosition += length + 1;
+
+		if (carried) {
+			mCarry.append(begin, length);
+			line.data = mCarry.data();
+			line.length = mCarry.length();
+		} else {
+			line.data = begin;
+			line.length = length;
+		}
+
+		return true;
+	}
+}
+
+bool Line_Reader::Next(std::string& line)
+{
+	Line_View view;
+
+	if (!Next(view)) {
+		return false;
+	}
+
+	line.assign(view.data, view.length);
+
+	return true;
+}
+
+bool Line_Reader::Is_Mapped() const
+{
+	return mMapping.Get_Data() != nullptr;
+}
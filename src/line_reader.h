@@ -0,0 +1,154 @@
+/**
+ * @file    line_reader.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains streaming line input over mapped files and pipes
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "mapped_file.h"
+
+/*
+ * View of single input line (without line terminator); valid until the next line is read
+ */
+struct Line_View
+{
+	const char* data = nullptr;
+	size_t length = 0;
+
+	bool empty() const
+	{
+		return length == 0;
+	}
+
+	bool operator==(const char* str) const
+	{
+		return std::strlen(str) == length && std::memcmp(data, str, length) == 0;
+	}
+
+	std::string str() const
+	{
+		return std::string(data, length);
+	}
+};
+
+/*
+ * Streaming line input - regular files are mapped to memory and lines are yielded directly from the mapping;
+ * pipes and standard input are read in large chunks, on background thread when not interactive
+ */
+class Line_Reader final
+{
+	public:
+		// size of single chunk read from pipe
+		static constexpr size_t Chunk_Size = 1024 * 1024;
+
+	private:
+		// mapped input file; unused for pipes
+		Mapped_File mMapping;
+		// read position within mapping or current chunk
+		size_t mPosition;
+
+		// input descriptor of pipe/stdin; -1 if mapped or closed
+		int mFd;
+		// should the descriptor be closed with reader?
+		bool mOwnsFd;
+		// the input has been fully read
+		bool mEof;
+
+		// chunk currently being consumed
+		std::vector<char> mChunk;
+		// beginning of line split by chunk boundary; the only case, when the line is copied
+		std::string mCarry;
+
+		// background thread reading chunks ahead, so the input is read while the previous chunk is being processed
+		std::thread mPrefetchThread;
+		// guards prefetched chunk handover
+		std::mutex mPrefetchMtx;
+		// signalled when the chunk is taken or filled
+		std::condition_variable mPrefetchCv;
+		// chunk read ahead by prefetch thread
+		std::vector<char> mPrefetched;
+		// is there a chunk ready in mPrefetched?
+		bool mPrefetchReady;
+		// prefetch thread reached end of input (or error)
+		bool mPrefetchEof;
+		// asks prefetch thread to stop
+		bool mPrefetchStop;
+
+	protected:
+		// reads single chunk directly from descriptor; returns false on end of input
+		bool Read_Chunk(std::vector<char>& chunk, bool interruptible);
+		// prefetch thread body
+		void Prefetch_Worker();
+		// replaces current chunk with the next one; returns false on end of input
+		bool Next_Chunk();
+		// starts reading from given descriptor
+		void Open_Descriptor(int fd, bool ownsFd);
+
+	public:
+		Line_Reader();
+		Line_Reader(const Line_Reader&) = delete;
+		Line_Reader& operator=(const Line_Reader&) = delete;
+		~Line_Reader();
+
+		// opens input file; regular files are mapped, anything else is read in chunks; returns false on failure
+		bool Open(const std::string& path);
+		// reads from standard input
+		void Open_Stdin();
+		// closes the input and stops the prefetch thread
+		void Close();
+
+		// retrieves next line; returns false at the end of input
+		bool Next(Line_View& line);
+		// retrieves next line into given string, reusing its storage; returns false at the end of input
+		bool Next(std::string& line);
+
+		// is the input mapped to memory?
+		bool Is_Mapped() const;
+};
@@ -0,0 +1,85 @@
+/**
+ * @file    lora_airtime.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of LoRa time-on-air estimation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "lora_airtime.h"
+
+size_t LoRaWAN_Max_Payload(const Lora_Radio_Settings& radio)
+{
+	// DR0 - DR2
+	if (radio.spreadingFactor >= 10 && radio.bandwidthKhz <= 125) {
+		return 51;
+	}
+	// DR3
+	if (radio.spreadingFactor == 9 && radio.bandwidthKhz <= 125) {
+		return 115;
+	}
+	// DR4 - DR6
+	return 222;
+}
+
+double Lora_Time_On_Air_Ms(const Lora_Radio_Settings& radio, size_t phyPayloadLen)
+{
+	const double symbolMs = std::pow(2.0, radio.spreadingFactor) / radio.bandwidthKhz;
+
+	// low data rate optimization is mandated for symbols longer than 16 ms
+	const int lowDataRate = (symbolMs > 16.0) ? 1 : 0;
+
+	const double preambleMs = (radio.preambleLength + 4.25) * symbolMs;
+
+	// see Semtech SX1276 datasheet, section 4.1.1.7
+	const double numerator = 8.0 * phyPayloadLen - 4.0 * radio.spreadingFactor + 28 + 16 * (radio.crc ? 1 : 0) - 20 * (radio.explicitHeader ? 0 : 1);
+	const double denominator = 4.0 * (radio.spreadingFactor - 2 * lowDataRate);
+
+	const double payloadSymbols = 8 + std::max(std::ceil(numerator / denominator) * (radio.codingRate + 4), 0.0);
+
+	return preambleMs + payloadSymbols * symbolMs;
+}
+
+double LoRaWAN_Time_On_Air_Ms(const Lora_Radio_Settings& radio, size_t appPayloadLen)
+{
+	return Lora_Time_On_Air_Ms(radio, appPayloadLen + LoRaWAN_Frame_Overhead);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file    lora_airtime.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains LoRa time-on-air estimation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+// LoRaWAN frame overhead around FRMPayload (MHDR, FHDR without FOpts, FPort, MIC)
+constexpr size_t LoRaWAN_Frame_Overhead = 13;
+
+/*
+ * LoRa radio settings of a transmission
+ */
+struct Lora_Radio_Settings
+{
+	int spreadingFactor = 12;			// spreading factor (7 - 12)
+	int bandwidthKhz = 125;				// bandwidth in kHz
+	int codingRate = 1;					// coding rate 4/(4 + codingRate), (1 - 4)
+	int preambleLength = 8;				// number of preamble symbols
+	bool explicitHeader = true;			// is the PHY header present?
+	bool crc = false;					// is the payload CRC present? (LoRaWAN downlinks have none)
+};
+
+// retrieves maximum application payload length for given radio settings (EU868 data rates)
+size_t LoRaWAN_Max_Payload(const Lora_Radio_Settings& radio);
+// estimates time on air of PHY payload of given length in ms
+double Lora_Time_On_Air_Ms(const Lora_Radio_Settings& radio, size_t phyPayloadLen);
+// estimates time on air of LoRaWAN frame with application payload of given length in ms
+double LoRaWAN_Time_On_Air_Ms(const Lora_Radio_Settings& radio, size_t appPayloadLen);
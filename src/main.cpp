@@ -43,16 +43,40 @@
  */
 
 #include <iostream>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <vector>
 #include <fstream>
+#include <algorithm>
 
 #include "mqtt_terminal.h"
 #include "terminal_handler.h"
+#include "command_dispatcher.h"
+#include "control_server.h"
+#include "control_client.h"
+#include "http_server.h"
+#include "trace_recorder.h"
+#include "fleet_runner.h"
+#include "airtime_planner.h"
+#include "capture_replay.h"
 
 #include "../dep/simpleini/SimpleIni.h"
 
 // global MQTT setting container
 static MQTT_Settings mqttSettings;
+// global journal setting container
+static Journal_Settings journalSettings;
+// global node store setting container
+static Node_Store_Settings storeSettings;
+// global downlink duty-cycle settings
+static Duty_Cycle_Settings dutyCycleSettings;
+// comma-separated list of command tree schema files
+static std::string schemaFiles;
+// global HTTP server settings
+static HTTP_Settings httpSettings;
+// maximum time the output could stay unflushed
+static long outputFlushIntervalMs = 100;
 
 /*
  * CLI parameters simple parser
@@ -85,6 +109,26 @@ class CLIParams
 		bool hasOpt(const std::string &option) const {
 			return std::find(tokens.begin(), tokens.end(), option) != tokens.end();
 		}
+
+		// retrieves non-negative numeric CLI option up to maxValue, keeps the value if not found; prints error and returns false on invalid value
+		template <typename T>
+		bool getNumOpt(const std::string &option, uint64_t maxValue, T& value) const {
+			if (!hasOpt(option))
+				return true;
+
+			const std::string str = getOpt(option, "");
+
+			errno = 0;
+			const uint64_t parsed = std::strtoull(str.c_str(), nullptr, 10);
+
+			if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos || errno == ERANGE || parsed > maxValue) {
+				std::cerr << "Invalid value of " << option << ": '" << str << "'; expected a number up to " << maxValue << std::endl;
+				return false;
+			}
+
+			value = static_cast<T>(parsed);
+			return true;
+		}
 };
 
 // loads config file from given path
@@ -96,51 +140,303 @@ bool Load_Config(const std::string& path)
 	}
 
 	mqttSettings.server = cfg.GetValue("mqtt", "server", nullptr);
-	mqttSettings.port = static_cast<uint16_t>(cfg.GetLongValue("mqtt", "port", 1883));
+	mqttSettings.tls = cfg.GetBoolValue("mqtt", "tls", false);
+	mqttSettings.port = static_cast<uint16_t>(cfg.GetLongValue("mqtt", "port", mqttSettings.tls ? 8883 : 1883));
 	mqttSettings.username = cfg.GetValue("mqtt", "username", nullptr);
 	mqttSettings.password = cfg.GetValue("mqtt", "password", nullptr);
+	mqttSettings.caFile = cfg.GetValue("mqtt", "ca-file", "");
+	mqttSettings.caPath = cfg.GetValue("mqtt", "ca-path", "");
+	mqttSettings.certFile = cfg.GetValue("mqtt", "cert-file", "");
+	mqttSettings.keyFile = cfg.GetValue("mqtt", "key-file", "");
+	mqttSettings.keyPassword = cfg.GetValue("mqtt", "key-password", "");
+	mqttSettings.ciphers = cfg.GetValue("mqtt", "ciphers", "");
+	mqttSettings.verify = cfg.GetBoolValue("mqtt", "verify", true);
+	mqttSettings.cleanSession = cfg.GetBoolValue("mqtt", "clean-session", true);
+	mqttSettings.reconnectAttempts = cfg.GetLongValue("mqtt", "reconnect-attempts", 0);
+	mqttSettings.reconnectMaxDelay = cfg.GetLongValue("mqtt", "reconnect-max-delay", 60);
+	mqttSettings.pahoTrace = cfg.GetValue("mqtt", "paho-trace", "none");
 	mqttSettings.rxTopic = cfg.GetValue("mqtt", "rx-topic", nullptr);
 	mqttSettings.txTopic = cfg.GetValue("mqtt", "tx-topic", nullptr);
+	mqttSettings.node = cfg.GetValue("mqtt", "node", "");
 	mqttSettings.clientIdentifier = cfg.GetValue("mqtt", "client-identifier", "RemoteTerminal");
 	mqttSettings.connectionTimeout = cfg.GetLongValue("mqtt", "connection-timeout", 30);
 	mqttSettings.keepaliveInterval = cfg.GetLongValue("mqtt", "keepalive-interval", 20);
+	mqttSettings.decodeThreads = cfg.GetLongValue("mqtt", "decode-threads", 0);
+	mqttSettings.dedupWindowMs = cfg.GetLongValue("mqtt", "dedup-window", 10000);
+	mqttSettings.dedupCapacity = cfg.GetLongValue("mqtt", "dedup-capacity", 8192);
+
+	mqttSettings.shareGroup = cfg.GetValue("cluster", "share-group", "");
+	mqttSettings.instanceCount = cfg.GetLongValue("cluster", "instances", 1);
+	mqttSettings.instanceIndex = cfg.GetLongValue("cluster", "instance-index", 0);
+	mqttSettings.forwardTopic = cfg.GetValue("cluster", "forward-topic", "ketcube/forward");
 
 	mqttSettings.loraPort = static_cast<uint16_t>(cfg.GetLongValue("lora", "port", 13));
+	mqttSettings.codec = cfg.GetValue("mqtt", "codec", "chirpstack-v3");
+	dutyCycleSettings.radio.spreadingFactor = static_cast<int>(cfg.GetLongValue("lora", "spreading-factor", 12));
+	dutyCycleSettings.radio.bandwidthKhz = static_cast<int>(cfg.GetLongValue("lora", "bandwidth", 125));
+	dutyCycleSettings.radio.codingRate = static_cast<int>(cfg.GetLongValue("lora", "coding-rate", 1));
+	mqttSettings.maxPayload = cfg.GetLongValue("lora", "max-payload", 0);
+
+	dutyCycleSettings.gatewayPercent = cfg.GetDoubleValue("duty-cycle", "gateway", 0);
+	dutyCycleSettings.nodePercent = cfg.GetDoubleValue("duty-cycle", "node", 0);
+	dutyCycleSettings.windowSecs = cfg.GetLongValue("duty-cycle", "window", 3600);
 
 	mqttSettings.responseTimeout = cfg.GetLongValue("terminal", "response-timeout", 60);
+	mqttSettings.minResponseTimeout = cfg.GetLongValue("terminal", "min-response-timeout", 5);
+	mqttSettings.maxResponseTimeout = cfg.GetLongValue("terminal", "max-response-timeout", 600);
+	mqttSettings.maxRetransmissions = cfg.GetLongValue("terminal", "max-retransmissions", 2);
 	mqttSettings.maxBatchCommands = cfg.GetLongValue("terminal", "max-batch-commands", 3);
+	mqttSettings.maxInFlight = cfg.GetLongValue("terminal", "max-in-flight", 0);
+	mqttSettings.maxInFlightPerGateway = cfg.GetLongValue("terminal", "max-in-flight-per-gateway", 0);
+	mqttSettings.priorityAging = cfg.GetLongValue("terminal", "priority-aging", 30);
+	schemaFiles = cfg.GetValue("terminal", "schemas", "");
+
+	httpSettings.bind = cfg.GetValue("http", "bind", "127.0.0.1");
+	httpSettings.port = static_cast<uint16_t>(cfg.GetLongValue("http", "port", 0));
+	httpSettings.maxJobs = cfg.GetLongValue("http", "max-jobs", 64);
+
+	outputFlushIntervalMs = cfg.GetLongValue("output", "flush-interval", 100);
+
+	journalSettings.file = cfg.GetValue("journal", "file", "");
+	journalSettings.capacityMb = cfg.GetLongValue("journal", "capacity-mb", 64);
+	journalSettings.syncIntervalMs = cfg.GetLongValue("journal", "sync-interval", 1000);
+
+	storeSettings.file = cfg.GetValue("store", "file", "");
+	storeSettings.capacity = cfg.GetLongValue("store", "capacity", 16384);
 
 	return true;
 }
 
+// "compile" subcommand - encodes the input script to binary packet file
+int Compile_Script(const CLIParams& params)
+{
+	std::string inputFile = params.getOpt("--input", params.getOpt("-i", ""));
+	std::string outputFile = params.getOpt("--output", params.getOpt("-o", ""));
+
+	size_t threadCount = 0;
+	if (!params.getNumOpt("--threads", 1024, threadCount)) {
+		return 3;
+	}
+
+	if (inputFile.empty() || outputFile.empty()) {
+		std::cerr << "Both input script and output file has to be specified" << std::endl;
+		return 3;
+	}
+
+	Line_Reader input;
+	if (!input.Open(inputFile)) {
+		std::cerr << "Could not open input file: " << inputFile << std::endl;
+		return 3;
+	}
+
+	// the terminal is never connected, it just provides the command encoder
+	MQTT_Terminal term(mqttSettings);
+	Command_Tree_Index index(get_cmd_tree());
+	Script_Compiler compiler(term, index, mqttSettings.maxBatchCommands);
+
+	if (!compiler.Compile(input, outputFile, std::cerr, threadCount)) {
+		std::cerr << "Compilation failed" << std::endl;
+		return 4;
+	}
+
+	return 0;
+}
+
+// "journal" subcommand - prints journal contents
+int Dump_Journal(const CLIParams& params, const std::string& path)
+{
+	uint64_t node = Frame_Journal::Node_Id(params.getOpt("--node", ""));
+	uint64_t fromMs = 0;
+	uint64_t toMs = 0;
+
+	if (!params.getNumOpt("--from", UINT64_MAX, fromMs) || !params.getNumOpt("--to", UINT64_MAX, toMs)) {
+		return 1;
+	}
+
+	if (!Frame_Journal::Dump(path, node, fromMs, toMs, std::cout)) {
+		std::cerr << "Could not read journal: " << path << std::endl;
+		return 3;
+	}
+
+	return 0;
+}
+
+// "export-schema" subcommand - exports command tree of this build, so it could be loaded by builds for newer firmware
+int Export_Schema(const CLIParams& params)
+{
+	std::string outputFile = params.getOpt("--output", params.getOpt("-o", ""));
+
+	if (outputFile.empty()) {
+		std::cerr << "Output file has to be specified" << std::endl;
+		return 3;
+	}
+
+	if (!Schema_Registry::Export(outputFile)) {
+		return 4;
+	}
+
+	return 0;
+}
+
+// client mode - submits commands to daemon over control socket
+int Run_Client(const CLIParams& params)
+{
+	std::string inputFile = params.getOpt("--input", params.getOpt("-i", ""));
+	std::string outputFile = params.getOpt("--output", params.getOpt("-o", ""));
+
+	size_t maxBatchCommands = 3;
+	if (!params.getNumOpt("--max-batch-commands", SIZE_MAX, maxBatchCommands)) {
+		return 1;
+	}
+
+	std::ifstream inFs;
+	if (!inputFile.empty()) {
+		inFs.open(inputFile);
+		if (!inFs.is_open()) {
+			std::cerr << "Could not open input file: " << inputFile << std::endl;
+			return 3;
+		}
+	}
+
+	std::ofstream outFs;
+	if (!outputFile.empty()) {
+		outFs.open(outputFile);
+		if (!outFs.is_open()) {
+			std::cerr << "Could not open output file: " << outputFile << std::endl;
+			return 3;
+		}
+	}
+
+	Control_Client client(outFs.is_open() ? outFs : std::cout);
+
+	if (!client.Connect(params.getOpt("--connect", ""))) {
+		return 2;
+	}
+
+	return client.Run(inFs.is_open() ? inFs : std::cin, params.getOpt("--node", ""), maxBatchCommands);
+}
+
 int main(int argc, char** argv)
 {
 	CLIParams params(argc, argv);
 
+	// the trace is written when main returns, after all the threads are stopped
+	Trace_Session traceSession(params.getOpt("--trace", ""));
+
+	if (argc > 2 && std::string(argv[1]) == "journal") {
+		return Dump_Journal(params, argv[2]);
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "export-schema") {
+		return Export_Schema(params);
+	}
+
+	// client mode just forwards the input to running daemon, no config or connection is needed
+	if (params.hasOpt("--connect")) {
+		return Run_Client(params);
+	}
+
+	const bool compileMode = (argc > 1 && std::string(argv[1]) == "compile");
+
 	std::string configLoc = params.getOpt("--config", params.getOpt("-c", "config.ini"));
 
-	if (!Load_Config(configLoc)) {
+	// compiling does not need any connection, so the config is optional there
+	mqttSettings.maxBatchCommands = 3;
+
+	if (!Load_Config(configLoc) && !compileMode) {
 		std::cerr << "Could not load config file" << std::endl;
 		return 1;
 	}
 
+	if (compileMode) {
+		return Compile_Script(params);
+	}
+
 	std::string inputFile = params.getOpt("--input", params.getOpt("-i", ""));
 	std::string outputFile = params.getOpt("--output", params.getOpt("-o", ""));
+	std::string profileFile = params.getOpt("--profile", "");
+	std::string stateFile = params.getOpt("--state", "");
+	std::string replayFile = params.getOpt("--replay", "");
+	std::string captureFile = params.getOpt("--replay-capture", "");
+
+	std::string targetsSpec = params.getOpt("--targets", "");
+
+	journalSettings.file = params.getOpt("--journal", journalSettings.file);
+	storeSettings.file = params.getOpt("--store", storeSettings.file);
+	mqttSettings.node = params.getOpt("--node", mqttSettings.node);
+	schemaFiles = params.getOpt("--schemas", schemaFiles);
+
+	if (!params.getNumOpt("--max-in-flight", LONG_MAX, mqttSettings.maxInFlight) || !params.getNumOpt("--max-in-flight-per-gateway", LONG_MAX, mqttSettings.maxInFlightPerGateway)
+		|| !params.getNumOpt("--instance", LONG_MAX, mqttSettings.instanceIndex) || !params.getNumOpt("--http", UINT16_MAX, httpSettings.port)) {
+		return 1;
+	}
+
+	Schema_Registry schemas;
+	if (!schemas.Load_List(schemaFiles)) {
+		return 3;
+	}
+
+	// declared before the terminal, so it is closed only after the receive path of terminal has stopped
+	Frame_Journal journal;
+	if (!journalSettings.file.empty() && !journal.Open(journalSettings)) {
+		std::cerr << "Could not create journal file: " << journalSettings.file << std::endl;
+		return 3;
+	}
 
 	MQTT_Terminal term(mqttSettings);
 
-	if (!term.Init()) {
-		return 2;
+	if (!journalSettings.file.empty()) {
+		term.Set_Journal(&journal);
 	}
 
-	std::ifstream inFs;
-	if (!inputFile.empty()) {
+	// sequence numbers, round-trip estimates and core API versions of nodes survive restarts
+	Node_Store store;
+	if (!storeSettings.file.empty() && !store.Open(storeSettings)) {
+		std::cerr << "Could not open node store file: " << storeSettings.file << std::endl;
+		return 3;
+	}
 
-		inFs.open(inputFile);
-		if (!inFs.is_open()) {
-			std::cerr << "Could not open input file: " << inputFile << std::endl;
+	// captured traffic is replayed without any broker
+	if (!captureFile.empty()) {
+		std::ifstream captureFs(captureFile);
+		if (!captureFs.is_open()) {
+			std::cerr << "Could not open capture file: " << captureFile << std::endl;
 			return 3;
 		}
+
+		Capture_Replayer replayer(term);
+		return replayer.Run(captureFs, params.hasOpt("--replay-realtime"), std::cout);
+	}
+
+	// compiled script is fully validated before connecting anywhere
+	Command_Tree_Index cmdIndex(get_cmd_tree());
+	Compiled_Script compiledScript(cmdIndex);
+
+	if (!replayFile.empty() && !compiledScript.Open(replayFile, std::cerr)) {
+		return 3;
+	}
+
+	std::vector<Fleet_Target> targets;
+	if (!targetsSpec.empty() && !Fleet_Runner::Load_Targets(targetsSpec, targets, std::cerr)) {
+		return 3;
+	}
+
+	// every instance runs just the nodes it owns, so all instances could be given the same targets
+	if (mqttSettings.instanceCount > 1 && !targetsSpec.empty()) {
+		const size_t allCount = targets.size();
+
+		targets.erase(std::remove_if(targets.begin(), targets.end(), [&term](const Fleet_Target& target) { return !term.Owns_Node(target.node); }), targets.end());
+
+		std::cerr << "Instance " << mqttSettings.instanceIndex << " owns " << targets.size() << " of " << allCount << " targets" << std::endl;
+	}
+
+	// regular files are mapped, pipes and standard input are read ahead in chunks
+	Line_Reader input;
+	if (inputFile.empty()) {
+		input.Open_Stdin();
+	} else if (!input.Open(inputFile)) {
+		std::cerr << "Could not open input file: " << inputFile << std::endl;
+		return 3;
 	}
 
 	std::ofstream outFs;
@@ -153,13 +449,123 @@ int main(int argc, char** argv)
 		}
 	}
 
+	std::ostream& output = outFs.is_open() ? outFs : std::cout;
+
+	Airtime_Planner planner(term, dutyCycleSettings.radio, static_cast<size_t>(mqttSettings.maxPayload));
+
+	// dry run - estimate airtime of the script without connecting anywhere
+	if (params.hasOpt("--plan")) {
+		std::vector<Command_Request> script;
+
+		if (!replayFile.empty()) {
+			Fleet_Runner::Load_Script(compiledScript, script);
+		} else if (!Fleet_Runner::Load_Script(term, input, static_cast<size_t>(mqttSettings.maxBatchCommands), script, std::cerr)) {
+			return 3;
+		}
+
+		planner.Plan(script, targets, dutyCycleSettings, output);
+		return 0;
+	}
+
+	if (!term.Init()) {
+		return 2;
+	}
+
+	// init dispatcher
+	Command_Dispatcher dispatcher(term, mqttSettings.responseTimeout);
+	dispatcher.Set_Retransmission(mqttSettings.minResponseTimeout, mqttSettings.maxResponseTimeout, mqttSettings.maxRetransmissions);
+	dispatcher.Set_Concurrency(static_cast<size_t>(mqttSettings.maxInFlight), static_cast<size_t>(mqttSettings.maxInFlightPerGateway));
+	dispatcher.Set_Duty_Cycle(dutyCycleSettings);
+	dispatcher.Set_Priority_Aging(mqttSettings.priorityAging);
+	dispatcher.Set_Schemas(&schemas);
+	dispatcher.Set_Node_Store(store.Is_Open() ? &store : nullptr, mqttSettings.node);
+	dispatcher.Start();
+
+	// daemon mode - keeps the connection and serves commands submitted over control socket
+	if (params.hasOpt("--daemon")) {
+		Control_Server server(dispatcher, static_cast<size_t>(mqttSettings.maxBatchCommands));
+		HTTP_Server httpServer(dispatcher, httpSettings, static_cast<size_t>(mqttSettings.maxBatchCommands));
+
+		if (!server.Open(params.getOpt("--daemon", ""))) {
+			return 3;
+		}
+
+		if (httpSettings.port != 0 && !httpServer.Start()) {
+			return 3;
+		}
+
+		const int ret = server.Run();
+		httpServer.Stop();
+
+		return ret;
+	}
+
+	// results are written by background thread, so slow output never holds the dispatcher
+	Output_Sink outputSink(output, outputFlushIntervalMs);
+	outputSink.Start();
+
+	// fan-out mode - the script is encoded once and sent to all targets
+	if (!targetsSpec.empty()) {
+		std::vector<Command_Request> script;
+
+		if (!replayFile.empty()) {
+			Fleet_Runner::Load_Script(compiledScript, script);
+		} else if (!Fleet_Runner::Load_Script(term, input, static_cast<size_t>(mqttSettings.maxBatchCommands), script, std::cerr)) {
+			return 3;
+		}
+
+		Fleet_Runner fleet(dispatcher, outputSink);
+		return fleet.Run(script, targets);
+	}
+
 	// init handler
 	Terminal_Handler handler(
-		inFs.is_open() ? inFs : std::cin,
-		outFs.is_open() ? outFs : std::cout,
-		mqttSettings.responseTimeout,
+		dispatcher,
+		input,
+		outputSink,
 		mqttSettings.maxBatchCommands
 	);
 
-	return handler.Run(term);
+	handler.Set_Planner(&planner);
+
+	if (!replayFile.empty()) {
+		return handler.Replay(compiledScript);
+	}
+
+	// desired-state mode - send just the difference between profile and last-known state
+	if (!profileFile.empty()) {
+		// state file keeps settings of every node separately
+		Config_Reconciler reconciler(term, mqttSettings.node);
+
+		std::ifstream profileFs(profileFile);
+		if (!profileFs.is_open()) {
+			std::cerr << "Could not open profile file: " << profileFile << std::endl;
+			return 3;
+		}
+
+		if (!reconciler.Load_Profile(profileFs, std::cerr)) {
+			return 3;
+		}
+
+		// missing state file is not an error - nothing is known about the node yet
+		if (!stateFile.empty()) {
+			std::ifstream stateFs(stateFile);
+			reconciler.Load_State(stateFs);
+		}
+
+		int ret = handler.Reconcile(reconciler);
+
+		if (!stateFile.empty()) {
+			std::ofstream stateFs(stateFile);
+			if (!stateFs.is_open()) {
+				std::cerr << "Could not store state file: " << stateFile << std::endl;
+				return 3;
+			}
+			reconciler.Save_State(stateFs);
+		}
+
+		return ret;
+	}
+
+	return handler.Run(params.hasOpt("--async"));
 }
@@ -0,0 +1,357 @@
+/**
+ * @file    mapped_file.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains memory-mapped file wrapper implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Mapped_File::Mapped_File()
+	: mData(nullptr), mSize(0)
+#ifdef _WIN32
+	, mFileHandle(INVALID_HANDLE_VALUE), mMapHandle(nullptr)
+#else
+	, mFd(-1)
+#endif
+{
+	//
+}
+
+Mapped_File::~Mapped_File()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool Mapped_File::Open(const std::string& path)
+{
+	LARGE_INTEGER size;
+
+	Close();
+
+	mFileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	if (!GetFileSizeEx(mFileHandle, &size)) {
+		Close();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(size.QuadPart);
+
+	// empty files could not be mapped, but are valid
+	if (mSize == 0) {
+		return true;
+	}
+
+	mMapHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapHandle == nullptr) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(MapViewOfFile(mMapHandle, FILE_MAP_READ, 0, 0, 0));
+	if (mData == nullptr) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool Mapped_File::Create(const std::string& path, size_t size)
+{
+	LARGE_INTEGER li;
+
+	Close();
+
+	mFileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	li.QuadPart = static_cast<LONGLONG>(size);
+
+	mMapHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READWRITE, li.HighPart, li.LowPart, nullptr);
+	if (mMapHandle == nullptr) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(MapViewOfFile(mMapHandle, FILE_MAP_WRITE, 0, 0, 0));
+	if (mData == nullptr) {
+		Close();
+		return false;
+	}
+
+	mSize = size;
+
+	return true;
+}
+
+bool Mapped_File::Open_Writable(const std::string& path, size_t size)
+{
+	LARGE_INTEGER li;
+
+	Close();
+
+	mFileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	if (!GetFileSizeEx(mFileHandle, &li)) {
+		Close();
+		return false;
+	}
+
+	// mapping of empty file extends it to the requested size
+	if (li.QuadPart == 0) {
+		li.QuadPart = static_cast<LONGLONG>(size);
+	}
+
+	mMapHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READWRITE, li.HighPart, li.LowPart, nullptr);
+	if (mMapHandle == nullptr) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(MapViewOfFile(mMapHandle, FILE_MAP_WRITE, 0, 0, 0));
+	if (mData == nullptr) {
+		Close();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(li.QuadPart);
+
+	return true;
+}
+
+void Mapped_File::Sync(bool async)
+{
+	if (mData != nullptr) {
+		FlushViewOfFile(mData, 0);
+		if (!async) {
+			FlushFileBuffers(mFileHandle);
+		}
+	}
+}
+
+void Mapped_File::Close()
+{
+	if (mData != nullptr) {
+		UnmapViewOfFile(mData);
+	}
+	if (mMapHandle != nullptr) {
+		CloseHandle(mMapHandle);
+	}
+	if (mFileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(mFileHandle);
+	}
+
+	mData = nullptr;
+	mSize = 0;
+	mMapHandle = nullptr;
+	mFileHandle = INVALID_HANDLE_VALUE;
+}
+
+void Mapped_File::Advise_Sequential()
+{
+	// no equivalent hint for mapped views
+}
+
+#else
+
+bool Mapped_File::Open(const std::string& path)
+{
+	struct stat st;
+
+	Close();
+
+	mFd = open(path.c_str(), O_RDONLY);
+	if (mFd < 0) {
+		return false;
+	}
+
+	if (fstat(mFd, &st) != 0) {
+		Close();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(st.st_size);
+
+	// empty files could not be mapped, but are valid
+	if (mSize == 0) {
+		return true;
+	}
+
+	void* addr = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, mFd, 0);
+	if (addr == MAP_FAILED) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(addr);
+
+	return true;
+}
+
+bool Mapped_File::Create(const std::string& path, size_t size)
+{
+	Close();
+
+	mFd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (mFd < 0) {
+		return false;
+	}
+
+	if (ftruncate(mFd, static_cast<off_t>(size)) != 0) {
+		Close();
+		return false;
+	}
+
+	mSize = size;
+
+	void* addr = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+	if (addr == MAP_FAILED) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(addr);
+
+	return true;
+}
+
+bool Mapped_File::Open_Writable(const std::string& path, size_t size)
+{
+	struct stat st;
+
+	Close();
+
+	mFd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (mFd < 0) {
+		return false;
+	}
+
+	if (fstat(mFd, &st) != 0) {
+		Close();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(st.st_size);
+
+	// new file is zero-filled up to the requested size
+	if (mSize == 0) {
+		if (ftruncate(mFd, static_cast<off_t>(size)) != 0) {
+			Close();
+			return false;
+		}
+		mSize = size;
+	}
+
+	void* addr = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+	if (addr == MAP_FAILED) {
+		Close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(addr);
+
+	return true;
+}
+
+void Mapped_File::Sync(bool async)
+{
+	if (mData != nullptr) {
+		msync(mData, mSize, async ? MS_ASYNC : MS_SYNC);
+	}
+}
+
+void Mapped_File::Close()
+{
+	if (mData != nullptr) {
+		munmap(mData, mSize);
+	}
+	if (mFd >= 0) {
+		close(mFd);
+	}
+
+	mData = nullptr;
+	mSize = 0;
+	mFd = -1;
+}
+
+void Mapped_File::Advise_Sequential()
+{
+	if (mData != nullptr) {
+		madvise(mData, mSize, MADV_SEQUENTIAL);
+	}
+}
+
+#endif
+
+const uint8_t* Mapped_File::Get_Data() const
+{
+	return mData;
+}
+
+uint8_t* Mapped_File::Get_Writable_Data()
+{
+	return mData;
+}
+
+size_t Mapped_File::Get_Size() const
+{
+	return mSize;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file    mapped_file.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains memory-mapped file wrapper
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/*
+ * Memory mapping of whole file; either read-only, or read-write with fixed size
+ */
+class Mapped_File
+{
+	private:
+		// mapped contents
+		uint8_t* mData;
+		// mapped size
+		size_t mSize;
+
+#ifdef _WIN32
+		// file handle
+		void* mFileHandle;
+		// file mapping handle
+		void* mMapHandle;
+#else
+		// file descriptor
+		int mFd;
+#endif
+
+	public:
+		Mapped_File();
+		Mapped_File(const Mapped_File&) = delete;
+		Mapped_File& operator=(const Mapped_File&) = delete;
+		virtual ~Mapped_File();
+
+		// maps the file for reading; returns false on failure
+		bool Open(const std::string& path);
+		// creates (or truncates) the file with given size and maps it for writing; returns false on failure
+		bool Create(const std::string& path, size_t size);
+		// maps existing file for writing keeping its contents and size; creates it with given size if it does not exist or is empty
+		bool Open_Writable(const std::string& path, size_t size);
+		// flushes changes to disk; asynchronously if requested
+		void Sync(bool async = true);
+		// unmaps the file
+		void Close();
+		// hints that the contents will be read sequentially, so the system reads ahead more aggressively
+		void Advise_Sequential();
+
+		// retrieves mapped contents
+		const uint8_t* Get_Data() const;
+		// retrieves mapped contents for writing; valid only when created using Create
+		uint8_t* Get_Writable_Data();
+		// retrieves mapped size
+		size_t Get_Size() const;
+};
@@ -44,20 +44,38 @@
 
 #include <iostream>
 
-#include "base64.h"
 #include "mqtt_terminal.h"
-#include "json11.hpp"
+#include "trace_recorder.h"
 
 #include <string>
+#include <algorithm>
+#include <ctime>
+#include <cctype>
+
+// initial downlink buffer size; fits the envelope with the largest LoRaWAN payload
+static const size_t Downlink_Buffer_Size = 512;
+
+// time given to in-flight messages when disconnecting
+static const int Disconnect_Timeout_Ms = 1000;
+
+// delay before the second reconnect attempt; the first one is made right away, every next one waits twice as long
+static const long Reconnect_Initial_Delay_Ms = 1000;
+
+// topic placeholder replaced by node DevEUI
+static const std::string Node_Placeholder = "{deveui}";
 
 // bridge function callback, calls the method od MQTT_Terminal context
 static int MQTT_Terminal_Bridge_Incoming_Message(void *context, char *topicName, int topicLen, MQTTClient_message *message)
 {
 	MQTT_Terminal* terminal = static_cast<MQTT_Terminal*>(context);
 	char* msgPtr = static_cast<char*>(message->payload);
+
+	Trace_Recorder::Set_Thread_Name("paho");
+	Trace_Span span("Paho message arrived");
+
 	std::string inMsg(msgPtr, msgPtr + message->payloadlen);
 
-	bool result = terminal->Incoming_Message(topicName, inMsg);
+	bool result = terminal->Incoming_Message(topicName, std::move(inMsg));
 
 	MQTTClient_freeMessage(&message);
 	MQTTClient_free(topicName);
@@ -70,9 +88,18 @@ static void MQTT_Terminal_Bridge_Connection_Lost(void *context, char *cause)
 {
 	MQTT_Terminal* terminal = static_cast<MQTT_Terminal*>(context);
 
+	Trace_Recorder::Set_Thread_Name("paho");
+	Trace_Span span("Paho connection lost");
+
 	terminal->Connection_Lost(cause ? cause : "");
 }
 
+// PAHO trace callback; the trace shows TLS handshake details, e.g. whether reconnect resumed the TLS session
+static void MQTT_Terminal_Bridge_Trace(enum MQTTCLIENT_TRACE_LEVELS level, char* message)
+{
+	std::cerr << "[paho] " << message << std::endl;
+}
+
 // bridge function callback, calls the method od MQTT_Terminal context
 void MQTT_Terminal_Bridge_Delivery_Complete(void* context, MQTTClient_deliveryToken dt)
 {
@@ -82,28 +109,123 @@ void MQTT_Terminal_Bridge_Delivery_Complete(void* context, MQTTClient_deliveryTo
 }
 
 MQTT_Terminal::MQTT_Terminal(const MQTT_Settings& settings)
-	: mSettings(settings)
+	: mSettings(settings), mClient(nullptr), mCodec(Payload_Codec::Create(settings.codec)), mTxBuffer(Downlink_Buffer_Size), mReconnecting(false), mStopping(false)
 {
-	//
+	// DevEUIs are compared in lowercase, as they appear in topics
+	std::transform(mSettings.node.begin(), mSettings.node.end(), mSettings.node.begin(), ::tolower);
+
+	mDedup.Configure(static_cast<uint64_t>(std::max(0L, mSettings.dedupWindowMs)), static_cast<size_t>(std::max(0L, mSettings.dedupCapacity)));
+}
+
+MQTT_Terminal::~MQTT_Terminal()
+{
+	{
+		std::unique_lock<std::mutex> lck(mReconnectMtx);
+		mStopping = true;
+	}
+
+	mReconnectCv.notify_all();
+
+	if (mReconnectThread.joinable()) {
+		mReconnectThread.join();
+	}
+
+	// stops the PAHO thread, so no callback runs anymore, when the decode pool and the rest of terminal go down
+	if (mClient != nullptr) {
+		MQTTClient_disconnect(mClient, Disconnect_Timeout_Ms);
+		MQTTClient_destroy(&mClient);
+	}
+
+	mDecodePool.Stop();
+}
+
+// returns nullptr for empty string, so the library uses its default
+static const char* Optional_String(const std::string& str)
+{
+	return str.empty() ? nullptr : str.c_str();
+}
+
+// hashes DevEUI case-insensitively (FNV-1a), so all instances agree on node owners regardless of platform
+static uint32_t Node_Hash(const std::string& devEui)
+{
+	uint32_t hash = 2166136261u;
+
+	for (char c : devEui) {
+		hash ^= static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c)));
+		hash *= 16777619u;
+	}
+
+	return hash;
 }
 
 bool MQTT_Terminal::Init()
 {
-	std::string connStr = "" + mSettings.server + ":" + std::to_string(mSettings.port);
+	std::string connStr = (mSettings.tls ? "ssl://" : "tcp://") + mSettings.server + ":" + std::to_string(mSettings.port);
+
+	if (!mCodec) {
+		std::cerr << "Unknown payload codec '" << mSettings.codec << "'; known codecs: " << Payload_Codec::Get_Names() << std::endl;
+		return false;
+	}
+
+	if (mSettings.instanceCount > 1) {
+		if (mSettings.rxTopic.find(Node_Placeholder) == std::string::npos) {
+			std::cerr << "Multiple instances require RX topic with " << Node_Placeholder << " placeholder" << std::endl;
+			return false;
+		}
 
-	std::cout << "Connecting to MQTT server " << mSettings.server << ":" << mSettings.port << " ... " << std::endl;
+		if (mSettings.instanceIndex < 0 || mSettings.instanceIndex >= mSettings.instanceCount) {
+			std::cerr << "Instance index " << mSettings.instanceIndex << " out of range of " << mSettings.instanceCount << " instances" << std::endl;
+			return false;
+		}
+	}
+
+	if (mSettings.pahoTrace == "protocol") {
+		MQTTClient_setTraceLevel(MQTTCLIENT_TRACE_PROTOCOL);
+		MQTTClient_setTraceCallback(MQTT_Terminal_Bridge_Trace);
+	} else if (mSettings.pahoTrace == "maximum") {
+		MQTTClient_setTraceLevel(MQTTCLIENT_TRACE_MAXIMUM);
+		MQTTClient_setTraceCallback(MQTT_Terminal_Bridge_Trace);
+	} else if (mSettings.pahoTrace != "none") {
+		std::cerr << "Unknown PAHO trace level '" << mSettings.pahoTrace << "'; known levels: none, protocol, maximum" << std::endl;
+		return false;
+	}
+
+	std::cout << "Connecting to MQTT server " << connStr << " ... " << std::endl;
 
 	mConnOpts = MQTTClient_connectOptions_initializer;
 
-	MQTTClient_create(&mClient, connStr.c_str(), "RemoteTerminal", MQTTCLIENT_PERSISTENCE_NONE, NULL);
+	// persistent session is bound to client identifier
+	if (MQTTClient_create(&mClient, connStr.c_str(), mSettings.clientIdentifier.c_str(), MQTTCLIENT_PERSISTENCE_NONE, NULL) != MQTTCLIENT_SUCCESS) {
+		std::cerr << "Unable to create MQTT client for " << connStr << std::endl;
+		return false;
+	}
+
 	mConnOpts.connectTimeout = mSettings.connectionTimeout;
 	mConnOpts.keepAliveInterval = mSettings.keepaliveInterval;
-	mConnOpts.cleansession = 1;
+	mConnOpts.cleansession = mSettings.cleanSession ? 1 : 0;
+
+	if (mSettings.tls) {
+		mSslOpts = MQTTClient_SSLOptions_initializer;
+		mSslOpts.trustStore = Optional_String(mSettings.caFile);
+		mSslOpts.CApath = Optional_String(mSettings.caPath);
+		mSslOpts.keyStore = Optional_String(mSettings.certFile);
+		mSslOpts.privateKey = Optional_String(mSettings.keyFile.empty() ? mSettings.certFile : mSettings.keyFile);
+		mSslOpts.privateKeyPassword = Optional_String(mSettings.keyPassword);
+		mSslOpts.enabledCipherSuites = Optional_String(mSettings.ciphers);
+		mSslOpts.enableServerCertAuth = mSettings.verify ? 1 : 0;
+		mSslOpts.verify = mSettings.verify ? 1 : 0;
+
+		mConnOpts.ssl = &mSslOpts;
+	}
 
 	mConnOpts.password = mSettings.password.c_str();
 	mConnOpts.username = mSettings.username.c_str();
 	mConnOpts.MQTTVersion = MQTTVERSION_DEFAULT;
 
+	mDecodePool.Start(static_cast<size_t>(mSettings.decodeThreads), [this](const std::string& node, const std::string& message) {
+		Decode_Uplink(node, message);
+	});
+
 	MQTTClient_setCallbacks(mClient, this, MQTT_Terminal_Bridge_Connection_Lost, MQTT_Terminal_Bridge_Incoming_Message, nullptr);
 
 	return Reconnect();
@@ -113,70 +235,351 @@ bool MQTT_Terminal::Reconnect()
 {
 	int rc;
 
+	const auto start = std::chrono::steady_clock::now();
+
 	if ((rc = MQTTClient_connect(mClient, &mConnOpts)) != MQTTCLIENT_SUCCESS) {
-		std::cerr << "Unable to connect to MQTT server" << std::endl;
+		std::cerr << "Unable to connect to MQTT server (error " << rc << ")" << std::endl;
 		return false;
 	}
 
-	std::cout << "Connected!" << std::endl;
+	// resumed TLS session saves a round-trip and the key exchange, which shows in the connect time
+	const auto connectMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
 
-	return (MQTTClient_subscribe(mClient, mSettings.rxTopic.c_str(), 0) == MQTTCLIENT_SUCCESS);
+	std::cout << "Connected! (" << connectMs << " ms)" << std::endl;
+
+	// the server still holds the subscription (and uplinks queued meanwhile) of persistent session
+	if (!mSettings.cleanSession && mConnOpts.returned.sessionPresent) {
+		std::cout << "MQTT session resumed" << std::endl;
+		return true;
+	}
+
+	// all nodes are received using single-level wildcard in place of DevEUI
+	std::string rxTopic = mSettings.rxTopic;
+	const size_t placeholderPos = rxTopic.find(Node_Placeholder);
+	if (placeholderPos != std::string::npos) {
+		rxTopic.replace(placeholderPos, Node_Placeholder.length(), "+");
+	}
+
+	// shared subscription - the server delivers every uplink to just one instance of the group
+	if (!mSettings.shareGroup.empty()) {
+		rxTopic = "$share/" + mSettings.shareGroup + "/" + rxTopic;
+	}
+
+	// QoS 1 lets the server queue uplinks for persistent session while disconnected
+	const int qos = mSettings.cleanSession ? 0 : 1;
+
+	if (MQTTClient_subscribe(mClient, rxTopic.c_str(), qos) != MQTTCLIENT_SUCCESS) {
+		return false;
+	}
+
+	// uplinks of owned nodes received by other instances
+	if (mSettings.instanceCount > 1) {
+		const std::string forwardTopic = Get_Forward_Topic(static_cast<size_t>(mSettings.instanceIndex), "+");
+
+		if (MQTTClient_subscribe(mClient, forwardTopic.c_str(), qos) != MQTTCLIENT_SUCCESS) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
-bool MQTT_Terminal::Send_Command(const std::vector<uint8_t>& parsed_command)
+size_t MQTT_Terminal::Get_Node_Owner(const std::string& node) const
 {
-	MQTTClient_message pubmsg = MQTTClient_message_initializer;
-	MQTTClient_deliveryToken token;
+	if (mSettings.instanceCount <= 1) {
+		return 0;
+	}
+
+	return Node_Hash(node.empty() ? mSettings.node : node) % static_cast<uint32_t>(mSettings.instanceCount);
+}
+
+bool MQTT_Terminal::Owns_Node(const std::string& node) const
+{
+	return Get_Node_Owner(node) == static_cast<size_t>(std::max(0L, mSettings.instanceIndex));
+}
+
+std::string MQTT_Terminal::Get_Forward_Topic(size_t instance, const std::string& node) const
+{
+	return mSettings.forwardTopic + "/" + std::to_string(instance) + "/" + node;
+}
+
+bool MQTT_Terminal::Get_Forwarded_Node(const std::string& topic, std::string& node) const
+{
+	if (mSettings.instanceCount <= 1) {
+		return false;
+	}
+
+	const std::string prefix = Get_Forward_Topic(static_cast<size_t>(mSettings.instanceIndex), "");
+
+	if (topic.length() <= prefix.length() || topic.compare(0, prefix.length(), prefix) != 0) {
+		return false;
+	}
+
+	node = topic.substr(prefix.length());
+
+	// default node is addressed by empty string everywhere
+	if (node == mSettings.node) {
+		node.clear();
+	}
+
+	return true;
+}
+
+bool MQTT_Terminal::Get_Tx_Topic(const std::string& node, std::string& topic) const
+{
+	const std::string& devEui = node.empty() ? mSettings.node : node;
+
+	topic = mSettings.txTopic;
+
+	const size_t placeholderPos = topic.find(Node_Placeholder);
+	if (placeholderPos == std::string::npos) {
+		// fixed topic addresses just the default node
+		return node.empty();
+	}
+
+	if (devEui.empty()) {
+		return false;
+	}
+
+	topic.replace(placeholderPos, Node_Placeholder.length(), devEui);
+
+	return true;
+}
+
+std::string MQTT_Terminal::Get_Rx_Node(const std::string& topic) const
+{
+	const size_t placeholderPos = mSettings.rxTopic.find(Node_Placeholder);
+	if (placeholderPos == std::string::npos) {
+		return "";
+	}
+
+	const size_t suffixLen = mSettings.rxTopic.length() - placeholderPos - Node_Placeholder.length();
 
-	std::string encodedMsg;
-	Base64::Encode(encodedMsg, parsed_command);
+	if (topic.length() < placeholderPos + suffixLen) {
+		return "";
+	}
+
+	std::string node = topic.substr(placeholderPos, topic.length() - placeholderPos - suffixLen);
+	std::transform(node.begin(), node.end(), node.begin(), ::tolower);
+
+	// default node is addressed by empty string everywhere
+	if (node == mSettings.node) {
+		return "";
+	}
+
+	return node;
+}
+
+bool MQTT_Terminal::Get_Tx_Node(const std::string& topic, std::string& node) const
+{
+	const std::string& txTopic = mSettings.txTopic;
+	const size_t placeholderPos = txTopic.find(Node_Placeholder);
+
+	node.clear();
+
+	if (placeholderPos == std::string::npos) {
+		return (topic == txTopic);
+	}
 
-	std::string payload = "{\"reference\": \"" + std::to_string(time(nullptr)) + "\", \"confirmed\": false, \"fPort\": " + std::to_string(mSettings.loraPort) + ", \"data\": \"" + encodedMsg + "\"}";
+	const size_t suffixLen = txTopic.length() - placeholderPos - Node_Placeholder.length();
 
-	pubmsg.payload = (void*)payload.c_str();
-	pubmsg.payloadlen = (int)payload.length();
+	// both the part before and after the placeholder have to match
+	if (topic.length() <= placeholderPos + suffixLen
+		|| topic.compare(0, placeholderPos, txTopic, 0, placeholderPos) != 0
+		|| topic.compare(topic.length() - suffixLen, suffixLen, txTopic, txTopic.length() - suffixLen, suffixLen) != 0) {
+		return false;
+	}
+
+	node = topic.substr(placeholderPos, topic.length() - placeholderPos - suffixLen);
+	std::transform(node.begin(), node.end(), node.begin(), ::tolower);
+
+	// default node is addressed by empty string everywhere
+	if (node == mSettings.node) {
+		node.clear();
+	}
+
+	return true;
+}
+
+uint8_t* MQTT_Terminal::Prepare_Downlink(const std::string& node, size_t packetLen, size_t& framePos)
+{
+	mCodec->Prepare_Downlink(mTxBuffer, node.empty() ? mSettings.node : node, mSettings.loraPort, packetLen, framePos);
+
+	return reinterpret_cast<uint8_t*>(mTxBuffer.data() + framePos);
+}
+
+bool MQTT_Terminal::Publish_Downlink(const std::string& topic, size_t framePos, size_t packetLen)
+{
+	MQTTClient_message pubmsg = MQTTClient_message_initializer;
+	MQTTClient_deliveryToken token;
+
+	pubmsg.payload = mTxBuffer.data();
+	pubmsg.payloadlen = static_cast<int>(mCodec->Finish_Downlink(mTxBuffer, framePos, packetLen));
 	pubmsg.qos = 0;
 	pubmsg.retained = 0;
-	MQTTClient_publishMessage(mClient, mSettings.txTopic.c_str(), &pubmsg, &token);
+
+	{
+		Trace_Span span("publish");
+		MQTTClient_publishMessage(mClient, topic.c_str(), &pubmsg, &token);
+	}
 
 	const unsigned long timeout = mSettings.connectionTimeout;
 
+	Trace_Span span("broker ack");
+
 	int rc = MQTTClient_waitForCompletion(mClient, token, timeout);
 
 	return (rc == MQTTCLIENT_SUCCESS);
 }
 
-bool MQTT_Terminal::Incoming_Message(const std::string& topicName, const std::string& message)
+bool MQTT_Terminal::Send_Command(const std::vector<uint8_t>& parsed_command)
+{
+	return Send_Command("", parsed_command);
+}
+
+bool MQTT_Terminal::Send_Command(const std::string& node, const std::vector<uint8_t>& parsed_command)
 {
-	std::string err;
-	json11::Json parsedMsg = json11::Json::parse(message, err);
+	size_t framePos;
+	std::string topic;
+
+	if (!Get_Tx_Topic(node, topic)) {
+		std::cerr << "Cannot address node '" << node << "' using TX topic " << mSettings.txTopic << std::endl;
+		return false;
+	}
 
-	if (!err.empty()) {
-		// TODO: proper message
-		std::cerr << "json parse error: " << err << std::endl;
+	// the response would arrive to another instance
+	if (!Owns_Node(node)) {
+		std::cerr << "Node '" << node << "' is owned by instance " << Get_Node_Owner(node) << std::endl;
 		return false;
 	}
 
-	if (parsedMsg["fPort"].int_value() == mSettings.loraPort && parsedMsg["data"].is_string()) {
+	std::unique_lock<std::mutex> lck(mTxMtx);
+
+	uint8_t* packet = Prepare_Downlink(node, parsed_command.size(), framePos);
+	std::copy(parsed_command.begin(), parsed_command.end(), packet);
+
+	Journal_Frame(Journal_Direction::Downlink, node.empty() ? mSettings.node : node, packet, parsed_command.size());
+
+	return Publish_Downlink(topic, framePos, parsed_command.size());
+}
+
+bool MQTT_Terminal::Incoming_Message(const std::string& topicName, std::string&& message)
+{
+	std::string node;
+
+	if (!Get_Forwarded_Node(topicName, node)) {
+		node = Get_Rx_Node(topicName);
 
-		std::vector<uint8_t> out;
-		Base64::Decode(out, parsedMsg["data"].string_value());
+		// shared subscription delivers uplinks of any node, but the owner is the one waiting for the response
+		if (!Owns_Node(node)) {
+			MQTTClient_message fwdmsg = MQTTClient_message_initializer;
 
-		std::unique_lock<std::mutex> lck(mQueue_Mtx);
+			fwdmsg.payload = const_cast<char*>(message.data());
+			fwdmsg.payloadlen = static_cast<int>(message.length());
+			fwdmsg.qos = 0;
+			fwdmsg.retained = 0;
 
-		mIncoming_Queue.push(std::move(out));
+			// not waiting for completion, this is the PAHO callback thread; lost message is covered by retransmission
+			const std::string fwdTopic = Get_Forward_Topic(Get_Node_Owner(node), node.empty() ? mSettings.node : node);
+			MQTTClient_publishMessage(mClient, fwdTopic.c_str(), &fwdmsg, nullptr);
 
-		mQueue_Cv.notify_one();
+			return true;
+		}
 	}
 
+	// byte-identical copies (e.g. overlapping subscriptions) are dropped before decoding
+	if (mDedup.Is_Duplicate(Uplink_Dedup::Message_Fingerprint(node, message))) {
+		return true;
+	}
+
+	// without running pool (e.g. capture replay), the message is decoded right away
+	if (!mDecodePool.Is_Running()) {
+		return Decode_Uplink(node, message);
+	}
+
+	// messages are routed by node, so the frames of every node stay in order; dropped when the terminal is going down
+	mDecodePool.Submit(std::move(node), std::move(message));
+
 	return true;
 }
 
+bool MQTT_Terminal::Decode_Uplink(const std::string& node, const std::string& message)
+{
+	std::vector<uint8_t> out;
+	uint16_t port;
+	uint32_t fCnt;
+
+	if (!mCodec || !mCodec->Decode_Uplink(message, port, fCnt, out)) {
+		std::cerr << "Malformed uplink message of node '" << (node.empty() ? mSettings.node : node) << "'" << std::endl;
+		return false;
+	}
+
+	if (port == mSettings.loraPort) {
+
+		// the same uplink heard by several gateways differs just in metadata
+		if (mDedup.Is_Duplicate(Uplink_Dedup::Frame_Fingerprint(node, fCnt, out))) {
+			return true;
+		}
+
+		Journal_Frame(Journal_Direction::Uplink, node.empty() ? mSettings.node : node, out.data(), out.size());
+
+		Enqueue_Message(node, std::move(out));
+	}
+
+	return true;
+}
+
+void MQTT_Terminal::Reconnect_Loop()
+{
+	std::chrono::milliseconds delay(0);
+	const std::chrono::milliseconds maxDelay(std::max(1L, mSettings.reconnectMaxDelay) * 1000);
+
+	for (long attempt = 1; ; attempt++) {
+		{
+			std::unique_lock<std::mutex> lck(mReconnectMtx);
+			if (mReconnectCv.wait_for(lck, delay, [this]() { return mStopping; })) {
+				return;
+			}
+		}
+
+		if (Reconnect()) {
+			return;
+		}
+
+		if (mSettings.reconnectAttempts > 0 && attempt >= mSettings.reconnectAttempts) {
+			std::cerr << "Giving up reconnecting to MQTT server after " << attempt << " attempts" << std::endl;
+			return;
+		}
+
+		delay = (delay.count() == 0) ? std::chrono::milliseconds(Reconnect_Initial_Delay_Ms) : std::min(delay * 2, maxDelay);
+
+		std::cerr << "Reconnect attempt " << attempt << " failed; retrying in " << delay.count() << " ms" << std::endl;
+	}
+}
+
 void MQTT_Terminal::Connection_Lost(const std::string& reason)
 {
-	// TODO: some message
+	std::cerr << "Connection to MQTT server lost" << (reason.empty() ? "" : ": " + reason) << "; reconnecting" << std::endl;
+
+	std::unique_lock<std::mutex> lck(mReconnectMtx);
+
+	// connection made by running reconnect may be lost before it subscribes; the running one keeps trying
+	if (mStopping || mReconnecting) {
+		return;
+	}
+
+	// the previous reconnect thread has already left its loop
+	if (mReconnectThread.joinable()) {
+		mReconnectThread.join();
+	}
+
+	mReconnecting = true;
+	mReconnectThread = std::thread([this]() {
+		Reconnect_Loop();
 
-	Reconnect();
+		std::unique_lock<std::mutex> lck(mReconnectMtx);
+		mReconnecting = false;
+	});
 }
 
 void MQTT_Terminal::Message_Delivered(const MQTTClient_deliveryToken& tok)
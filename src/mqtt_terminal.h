@@ -45,6 +45,9 @@
 #pragma once
 
 #include "terminal.h"
+#include "decode_pool.h"
+#include "payload_codec.h"
+#include "uplink_dedup.h"
 
 // PAHO client is written in pure C, to avoid linkage errors, let's wrap it in extern "C" block
 extern "C"
@@ -64,15 +67,45 @@ struct MQTT_Settings
 
 	std::string username;				// login username
 	std::string password;				// login password
+
+	bool tls;							// use TLS connection
+	std::string caFile;					// PEM file with trusted CA certificates
+	std::string caPath;					// directory with trusted CA certificates
+	std::string certFile;				// PEM file with client certificate (for client authentication)
+	std::string keyFile;				// PEM file with client private key; may be the same as certificate file
+	std::string keyPassword;			// client private key password
+	std::string ciphers;				// OpenSSL cipher list; library default if empty
+	bool verify;						// verify server certificate and hostname
+	bool cleanSession;					// start with clean MQTT session on every (re)connect
+	long reconnectAttempts;				// how many times to try reconnecting after lost connection (0 = forever)
+	long reconnectMaxDelay;				// upper bound of delay between reconnect attempts in seconds
+	std::string pahoTrace;				// PAHO library trace level printed to stderr (none, protocol, maximum)
 	
 	uint16_t loraPort;					// which LoRa port to use for remote terminal
-	std::string txTopic;				// TX topic (server to node)
-	std::string rxTopic;				// RX topic (node to server)
+	std::string codec;					// network server payload format (see Payload_Codec::Get_Names)
+	long maxPayload;					// maximum LoRaWAN application payload (0 = given by data rate)
+	std::string txTopic;				// TX topic (server to node); may contain {deveui} placeholder
+	std::string rxTopic;				// RX topic (node to server); may contain {deveui} placeholder
+	std::string node;					// DevEUI of default node, substituted to topic placeholder
 
 	long connectionTimeout;				// seconds to give up connecting
 	long keepaliveInterval;				// interval for MQTT keepalive
-	long responseTimeout;				// how many seconds to wait for response from node
+	long responseTimeout;				// how many seconds to wait for response from node before any round-trip is measured
+	long minResponseTimeout;			// lower bound of adaptive response timeout in seconds
+	long maxResponseTimeout;			// upper bound of adaptive response timeout in seconds
+	long maxRetransmissions;			// how many times to retransmit command without response
 	long maxBatchCommands;				// maximum number of commands in batch
+	long maxInFlight;					// maximum number of nodes with command in flight (0 = unlimited)
+	long maxInFlightPerGateway;			// maximum number of nodes with command in flight per gateway (0 = unlimited)
+	long priorityAging;					// waiting time in seconds after which queued command is promoted by one priority class (0 = never)
+	long decodeThreads;					// number of threads decoding uplinks (0 = by CPU count)
+	long dedupWindowMs;					// uplink copies received within this time are dropped (0 = no deduplication)
+	long dedupCapacity;					// number of uplinks remembered for deduplication
+
+	std::string shareGroup;				// shared subscription group of all instances; plain subscription if empty
+	long instanceCount;					// number of instances the nodes are distributed among
+	long instanceIndex;					// index of this instance (0 .. instanceCount - 1)
+	std::string forwardTopic;			// topic prefix uplinks received by other instance than the owner are forwarded under
 };
 
 /*
@@ -85,19 +118,71 @@ class MQTT_Terminal : public Terminal_Base
 		MQTT_Settings mSettings;
 		// MQTT connection options
 		MQTTClient_connectOptions mConnOpts;
+		// TLS options; the client keeps TLS session of last connection and resumes it on reconnect
+		MQTTClient_SSLOptions mSslOpts;
 		// PAHO MQTT client instance
 		MQTTClient mClient;
 
+		// filter of uplinks received more than once
+		Uplink_Dedup mDedup;
+		// network server payload format; nullptr if the configured one is not known
+		std::unique_ptr<Payload_Codec> mCodec;
+		// downlink message buffer; reused for every downlink, grows as needed
+		std::vector<char> mTxBuffer;
+		// mutex guarding downlink message buffer
+		std::mutex mTxMtx;
+
+		// threads decoding uplinks, so the PAHO callback thread just hands messages over; destroyed first, as it calls back to this terminal
+		Decode_Pool mDecodePool;
+
+		// thread reconnecting after lost connection, so the PAHO callback thread is not blocked by reconnect attempts
+		std::thread mReconnectThread;
+		// mutex guarding reconnect state
+		std::mutex mReconnectMtx;
+		// condition variable waking reconnect thread from backoff delay when stopping
+		std::condition_variable mReconnectCv;
+		// is the reconnect thread running?
+		bool mReconnecting;
+		// is the terminal being destroyed?
+		bool mStopping;
+
 	protected:
-		// (re)connects to the server; returns true on success
+		// (re)connects to the server using the same client instance, so the TLS session is resumed; returns true on success
 		bool Reconnect();
+		// retries reconnect with exponentially growing delay until it succeeds, the attempts run out or the terminal is stopped
+		void Reconnect_Loop();
+
+		// retrieves TX topic of given node; returns false if the node could not be addressed
+		bool Get_Tx_Topic(const std::string& node, std::string& topic) const;
+		// retrieves node the RX topic belongs to; empty for default node
+		std::string Get_Rx_Node(const std::string& topic) const;
+
+		// writes downlink message of given node to message buffer; returns the place, where raw packet of given length has to be written
+		uint8_t* Prepare_Downlink(const std::string& node, size_t packetLen, size_t& framePos);
+		// completes message with raw packet written to message buffer and publishes it to given topic
+		bool Publish_Downlink(const std::string& topic, size_t framePos, size_t packetLen);
+
+		// retrieves topic uplinks of given node are forwarded to given instance under
+		std::string Get_Forward_Topic(size_t instance, const std::string& node) const;
+		// resolves node of uplink forwarded by other instance; returns false if the topic is not forward topic of this instance
+		bool Get_Forwarded_Node(const std::string& topic, std::string& node) const;
+
+		// decodes uplink message of given node and pushes the frame to incoming queue; returns false if the message is malformed
+		bool Decode_Uplink(const std::string& node, const std::string& message);
 
 	public:
 		MQTT_Terminal(const MQTT_Settings& settings);
-		virtual ~MQTT_Terminal() = default;
+		virtual ~MQTT_Terminal();
+
+		// retrieves index of instance owning given node; nodes are distributed among instances by hash of DevEUI
+		size_t Get_Node_Owner(const std::string& node) const;
+		// is given node owned by this instance? only the owner sends downlinks to node, so it also receives the responses
+		bool Owns_Node(const std::string& node) const;
+		// resolves node addressed by TX topic (empty for default node); returns false if the topic is not TX topic
+		bool Get_Tx_Node(const std::string& topic, std::string& node) const;
 
 		// PAHO-called method upon receiving a new message
-		bool Incoming_Message(const std::string& topicName, const std::string& message);
+		bool Incoming_Message(const std::string& topicName, std::string&& message);
 		// PAHO-called method when the connection is lost
 		void Connection_Lost(const std::string& reason);
 		// PAHO-called method upon delivering message with given token
@@ -107,4 +192,5 @@ class MQTT_Terminal : public Terminal_Base
 
 		virtual bool Init() override;
 		virtual bool Send_Command(const std::vector<uint8_t>& parsed_command) override;
+		virtual bool Send_Command(const std::string& node, const std::vector<uint8_t>& parsed_command) override;
 };
@@ -0,0 +1,301 @@
+/**
+ * @file    node_store.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of persistent memory-mapped store of node state
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "node_store.h"
+
+static_assert(sizeof(Node_Store_Header) == 16, "Unexpected node store header size");
+static_assert(sizeof(Node_State) == 32, "Unexpected node state size");
+static_assert(sizeof(Node_Store_Record) == 96, "Unexpected node store record size");
+
+static const char Node_Store_Magic[4] = { 'K', 'R', 'T', 'N' };
+static const uint16_t Node_Store_Format_Version = 1;
+
+// every slot holds two copies of record
+constexpr size_t Node_Store_Copies = 2;
+
+// FNV-1a hash of given bytes
+static uint64_t Fnv1a_64(const void* data, size_t length)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < length; i++) {
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+// retrieves size of store file of given capacity
+static size_t Store_Size(size_t capacity)
+{
+	return sizeof(Node_Store_Header) + capacity * Node_Store_Copies * sizeof(Node_Store_Record);
+}
+
+Node_Store::Node_Store()
+	: mCapacity(0), mCount(0), mFullReported(false)
+{
+	//
+}
+
+Node_Store::~Node_Store()
+{
+	Close();
+}
+
+uint32_t Node_Store::Checksum(const Node_Store_Record& record)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+	const uint64_t hash = Fnv1a_64(bytes + sizeof(record.checksum), sizeof(record) - sizeof(record.checksum));
+
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+Node_Store_Record* Node_Store::Get_Slot(size_t index)
+{
+	return reinterpret_cast<Node_Store_Record*>(mFile.Get_Writable_Data() + sizeof(Node_Store_Header)) + index * Node_Store_Copies;
+}
+
+const Node_Store_Record* Node_Store::Get_Slot(size_t index) const
+{
+	return reinterpret_cast<const Node_Store_Record*>(mFile.Get_Data() + sizeof(Node_Store_Header)) + index * Node_Store_Copies;
+}
+
+const Node_Store_Record* Node_Store::Get_Current(const Node_Store_Record* slot)
+{
+	const Node_Store_Record* current = nullptr;
+
+	for (size_t i = 0; i < Node_Store_Copies; i++) {
+		const Node_Store_Record& copy = slot[i];
+
+		// torn write leaves bad checksum, the other copy is still valid
+		if (copy.generation == 0 || copy.checksum != Checksum(copy)) {
+			continue;
+		}
+
+		if (current == nullptr || copy.generation > current->generation) {
+			current = &copy;
+		}
+	}
+
+	return current;
+}
+
+bool Node_Store::Find_Slot(const std::string& node, size_t& index, bool& found) const
+{
+	if (mCapacity == 0 || node.empty() || node.length() >= sizeof(Node_Store_Record::node)) {
+		return false;
+	}
+
+	index = static_cast<size_t>(Fnv1a_64(node.data(), node.length()) % mCapacity);
+
+	// linear probing; nodes are never removed, so the first free slot ends the search
+	for (size_t probe = 0; probe < mCapacity; probe++) {
+		const Node_Store_Record* current = Get_Current(Get_Slot(index));
+
+		if (current == nullptr) {
+			found = false;
+			return true;
+		}
+
+		if (strncmp(current->node, node.c_str(), sizeof(current->node)) == 0) {
+			found = true;
+			return true;
+		}
+
+		index = (index + 1) % mCapacity;
+	}
+
+	return false;
+}
+
+bool Node_Store::Create(const std::string& path)
+{
+	Node_Store_Header hdr;
+
+	if (!mFile.Create(path, Store_Size(mCapacity))) {
+		return false;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, Node_Store_Magic, sizeof(hdr.magic));
+	hdr.formatVersion = Node_Store_Format_Version;
+	hdr.recordSize = sizeof(Node_Store_Record);
+	hdr.capacity = static_cast<uint32_t>(mCapacity);
+
+	memcpy(mFile.Get_Writable_Data(), &hdr, sizeof(hdr));
+	mFile.Sync(false);
+
+	return true;
+}
+
+bool Node_Store::Open(const Node_Store_Settings& settings)
+{
+	Node_Store_Header hdr;
+
+	Close();
+
+	if (settings.capacity <= 0 || settings.capacity > static_cast<long>(UINT32_MAX)) {
+		return false;
+	}
+
+	mCapacity = static_cast<size_t>(settings.capacity);
+
+	if (!mFile.Open_Writable(settings.file, Store_Size(mCapacity)) || mFile.Get_Size() < sizeof(hdr)) {
+		return false;
+	}
+
+	memcpy(&hdr, mFile.Get_Data(), sizeof(hdr));
+
+	const bool valid = memcmp(hdr.magic, Node_Store_Magic, sizeof(hdr.magic)) == 0 && hdr.formatVersion == Node_Store_Format_Version
+		&& hdr.recordSize == sizeof(Node_Store_Record) && hdr.capacity != 0 && mFile.Get_Size() == Store_Size(hdr.capacity);
+
+	if (valid) {
+		// stored nodes are hashed by capacity of the file, so it is kept until the file is deleted
+		if (hdr.capacity != mCapacity) {
+			std::cerr << "Node store " << settings.file << " keeps its capacity of " << hdr.capacity << " nodes" << std::endl;
+		}
+		mCapacity = hdr.capacity;
+	} else {
+		const bool empty = (memcmp(hdr.magic, "\0\0\0\0", sizeof(hdr.magic)) == 0);
+		if (!empty) {
+			std::cerr << "Node store " << settings.file << " has unknown format, starting with empty store" << std::endl;
+		}
+
+		if (!Create(settings.file)) {
+			return false;
+		}
+	}
+
+	mCount = 0;
+	for (size_t i = 0; i < mCapacity; i++) {
+		if (Get_Current(Get_Slot(i)) != nullptr) {
+			mCount++;
+		}
+	}
+
+	mFullReported = false;
+
+	return true;
+}
+
+void Node_Store::Close()
+{
+	if (mFile.Get_Data() == nullptr) {
+		return;
+	}
+
+	mFile.Sync(false);
+	mFile.Close();
+
+	mCapacity = 0;
+	mCount = 0;
+}
+
+bool Node_Store::Is_Open() const
+{
+	return mFile.Get_Data() != nullptr;
+}
+
+bool Node_Store::Get(const std::string& node, Node_State& state) const
+{
+	size_t index;
+	bool found;
+
+	if (!Find_Slot(node, index, found) || !found) {
+		return false;
+	}
+
+	memcpy(&state, &Get_Current(Get_Slot(index))->state, sizeof(state));
+
+	return true;
+}
+
+bool Node_Store::Put(const std::string& node, const Node_State& state)
+{
+	Node_Store_Record record;
+	size_t index;
+	bool found;
+
+	if (node.empty() || node.length() >= sizeof(record.node)) {
+		return false;
+	}
+
+	if (!Find_Slot(node, index, found)) {
+		if (!mFullReported && mCapacity != 0) {
+			std::cerr << "Node store is full, state of further nodes is not kept" << std::endl;
+			mFullReported = true;
+		}
+		return false;
+	}
+
+	Node_Store_Record* slot = Get_Slot(index);
+	const Node_Store_Record* current = Get_Current(slot);
+
+	memset(&record, 0, sizeof(record));
+	record.generation = (current != nullptr) ? current->generation + 1 : 1;
+	strncpy(record.node, node.c_str(), sizeof(record.node) - 1);
+	record.state = state;
+	record.state.updatedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	record.checksum = Checksum(record);
+
+	// the older copy is overwritten, so the current one survives crash in the middle of the write
+	Node_Store_Record* target = (current == &slot[0]) ? &slot[1] : &slot[0];
+	memcpy(target, &record, sizeof(record));
+
+	if (!found) {
+		mCount++;
+	}
+
+	return true;
+}
+
+size_t Node_Store::Get_Count() const
+{
+	return mCount;
+}
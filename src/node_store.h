@@ -0,0 +1,157 @@
+/**
+ * @file    node_store.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains persistent memory-mapped store of node state
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mapped_file.h"
+
+/*
+ * Container of node store settings
+ */
+struct Node_Store_Settings
+{
+	std::string file;					// store file path; store disabled if empty
+	long capacity;						// maximum number of nodes
+};
+
+/*
+ * Node store file header
+ */
+struct Node_Store_Header
+{
+	char magic[4];						// always "KRTN"
+	uint16_t formatVersion;				// version of this file format
+	uint16_t recordSize;				// size of single record copy
+	uint32_t capacity;					// number of slots
+	uint32_t reserved;					// reserved, zero
+};
+
+/*
+ * Flags of stored node state
+ */
+enum Node_State_Flags : uint8_t
+{
+	Node_State_Has_Seq = 0x01,			// last used sequence number is known
+	Node_State_Has_Rtt = 0x02,			// round-trip time was measured
+};
+
+/*
+ * State of single node kept across restarts
+ */
+struct Node_State
+{
+	uint16_t coreApiVersion;			// core API version the node understood; zero if unknown
+	uint8_t seq;						// last used sequence number
+	uint8_t flags;						// Node_State_Flags
+	uint32_t reserved;					// reserved, zero
+	double srttMs;						// smoothed round-trip time
+	double rttVarMs;					// round-trip time variance
+	int64_t updatedMs;					// wall clock time (ms since epoch) of last update
+};
+
+/*
+ * Single copy of node record; every slot holds two copies, so a torn write never destroys the previous state
+ */
+struct Node_Store_Record
+{
+	uint32_t checksum;					// checksum of the rest of record
+	uint32_t generation;				// incremented on every write; zero means never written
+	char node[56];						// node identifier, zero padded
+	Node_State state;					// node state
+};
+
+/*
+ * Embedded key-value store of node state in memory-mapped file; nodes are placed in hash table directly
+ * in the file, so opening it takes no loading - lookups read the mapped pages;
+ * the store is not thread-safe, its user (dispatcher) serializes the access
+ */
+class Node_Store
+{
+	private:
+		// mapped store file
+		Mapped_File mFile;
+		// number of slots
+		size_t mCapacity;
+		// number of occupied slots
+		size_t mCount;
+		// was the "store full" warning already printed?
+		bool mFullReported;
+
+	protected:
+		// retrieves the first copy of record in given slot
+		Node_Store_Record* Get_Slot(size_t index);
+		const Node_Store_Record* Get_Slot(size_t index) const;
+		// retrieves the valid copy of slot with the newest generation; nullptr if none of them is valid
+		static const Node_Store_Record* Get_Current(const Node_Store_Record* slot);
+		// finds slot of node or the free slot it belongs to; returns false if the node is not stored and there is no free slot
+		bool Find_Slot(const std::string& node, size_t& index, bool& found) const;
+		// initializes empty store file
+		bool Create(const std::string& path);
+
+		// computes checksum of record copy
+		static uint32_t Checksum(const Node_Store_Record& record);
+
+	public:
+		Node_Store();
+		Node_Store(const Node_Store&) = delete;
+		Node_Store& operator=(const Node_Store&) = delete;
+		virtual ~Node_Store();
+
+		// opens store file, creates it if it does not exist or has different format; returns false on failure
+		bool Open(const Node_Store_Settings& settings);
+		// flushes and closes the store
+		void Close();
+		// is the store open?
+		bool Is_Open() const;
+
+		// retrieves state of node; returns false if nothing is stored
+		bool Get(const std::string& node, Node_State& state) const;
+		// stores state of node; returns false if the store is full or the node has no valid DevEUI
+		bool Put(const std::string& node, const Node_State& state);
+		// retrieves number of stored nodes
+		size_t Get_Count() const;
+};
@@ -0,0 +1,192 @@
+/**
+ * @file    output_sink.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains asynchronous buffered output sink implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "output_sink.h"
+
+Output_Sink::Output_Sink(std::ostream& stream, long flushIntervalMs)
+	: mStream(stream), mFlushInterval(flushIntervalMs), mFlushRequested(false), mStop(false), mRunning(false), mFailed(false)
+{
+	//
+}
+
+Output_Sink::~Output_Sink()
+{
+	Stop();
+}
+
+void Output_Sink::Start()
+{
+	if (mWriterThread.joinable()) {
+		return;
+	}
+
+	mStop = false;
+	mRunning = true;
+	mWriterThread = std::thread(&Output_Sink::Writer_Worker, this);
+}
+
+void Output_Sink::Stop()
+{
+	if (!mWriterThread.joinable()) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+		mStop = true;
+	}
+	mCv.notify_all();
+
+	mWriterThread.join();
+
+	// records enqueued while the writer was finishing
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	mRunning = false;
+
+	for (const std::string& record : mQueue) {
+		mStream.write(record.data(), static_cast<std::streamsize>(record.length()));
+	}
+	mQueue.clear();
+
+	mStream.flush();
+}
+
+void Output_Sink::Write(std::string&& record, bool flush)
+{
+	{
+		std::unique_lock<std::mutex> lck(mMtx);
+
+		if (!mRunning) {
+			mStream.write(record.data(), static_cast<std::streamsize>(record.length()));
+			if (flush) {
+				mStream.flush();
+			}
+			return;
+		}
+
+		mQueue.push_back(std::move(record));
+		mFlushRequested = mFlushRequested || flush;
+	}
+
+	mCv.notify_one();
+}
+
+void Output_Sink::Write_Line(const std::string& line)
+{
+	std::string record;
+	record.reserve(line.length() + 1);
+	record.append(line);
+	record.push_back('\n');
+
+	Write(std::move(record));
+}
+
+bool Output_Sink::Good() const
+{
+	return !mFailed;
+}
+
+void Output_Sink::Writer_Worker()
+{
+	// records are taken in batches by swapping the queues, so both keep their capacity
+	std::vector<std::string> pending;
+	auto lastFlush = std::chrono::steady_clock::now();
+	bool dirty = false;
+
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	while (true) {
+		const auto hasWork = [this]() { return !mQueue.empty() || mFlushRequested || mStop; };
+
+		// unflushed data waits at most for the flush interval
+		if (dirty) {
+			mCv.wait_until(lck, lastFlush + mFlushInterval, hasWork);
+		} else {
+			mCv.wait(lck, hasWork);
+		}
+
+		pending.swap(mQueue);
+		const bool flushNow = mFlushRequested || mStop;
+		const bool stop = mStop;
+		mFlushRequested = false;
+
+		lck.unlock();
+
+		for (const std::string& record : pending) {
+			mStream.write(record.data(), static_cast<std::streamsize>(record.length()));
+		}
+
+		dirty = dirty || !pending.empty();
+		pending.clear();
+
+		const auto now = std::chrono::steady_clock::now();
+		if (dirty && (flushNow || now >= lastFlush + mFlushInterval)) {
+			mStream.flush();
+			lastFlush = now;
+			dirty = false;
+		}
+
+		if (!mStream.good()) {
+			mFailed = true;
+		}
+
+		if (stop) {
+			return;
+		}
+
+		lck.lock();
+	}
+}
+
+Output_Record::Output_Record(Output_Sink& sink)
+	: mSink(sink)
+{
+	//
+}
+
+Output_Record::~Output_Record()
+{
+	mSink.Write(str());
+}
@@ -0,0 +1,122 @@
+/**
+ * @file    output_sink.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains asynchronous buffered output sink
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+/*
+ * Asynchronous output sink - records are enqueued by any thread and written in batches by background writer thread,
+ * so slow terminal or disk never blocks the caller
+ */
+class Output_Sink final
+{
+	private:
+		// target stream
+		std::ostream& mStream;
+		// maximum time written records could stay unflushed
+		std::chrono::milliseconds mFlushInterval;
+
+		// writer thread
+		std::thread mWriterThread;
+		// guards queue and flags
+		std::mutex mMtx;
+		// signalled on new record, flush request or stop
+		std::condition_variable mCv;
+		// records waiting to be written
+		std::vector<std::string> mQueue;
+		// flush was requested by last writer
+		bool mFlushRequested;
+		// writer should write remaining records and end
+		bool mStop;
+		// is the writer thread running? records are written directly otherwise
+		bool mRunning;
+		// writing to stream failed
+		std::atomic<bool> mFailed;
+
+	protected:
+		// writer thread body
+		void Writer_Worker();
+
+	public:
+		Output_Sink(std::ostream& stream, long flushIntervalMs = 100);
+		Output_Sink(const Output_Sink&) = delete;
+		Output_Sink& operator=(const Output_Sink&) = delete;
+		~Output_Sink();
+
+		// starts the writer thread
+		void Start();
+		// writes all enqueued records, flushes the stream and stops the writer thread
+		void Stop();
+
+		// enqueues record (including line terminator); flush requests the stream to be flushed right after it, e.g. for prompts
+		void Write(std::string&& record, bool flush = false);
+		// enqueues single line
+		void Write_Line(const std::string& line);
+
+		// did all writes so far succeed?
+		bool Good() const;
+};
+
+/*
+ * Output record formatted using stream operators; enqueued to sink when destroyed
+ */
+class Output_Record final : public std::ostringstream
+{
+	private:
+		// target sink
+		Output_Sink& mSink;
+
+	public:
+		explicit Output_Record(Output_Sink& sink);
+		~Output_Record();
+};
@@ -0,0 +1,407 @@
+/**
+ * @file    payload_codec.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of network server payload codecs
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "payload_codec.h"
+#include "base64.h"
+#include "json11.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <ctime>
+
+std::unique_ptr<Payload_Codec> Payload_Codec::Create(const std::string& name)
+{
+	if (name == "chirpstack-v3") {
+		return std::unique_ptr<Payload_Codec>(new ChirpStack_V3_Codec());
+	} else if (name == "chirpstack-v4") {
+		return std::unique_ptr<Payload_Codec>(new ChirpStack_V4_Codec());
+	} else if (name == "chirpstack-v4-protobuf") {
+		return std::unique_ptr<Payload_Codec>(new ChirpStack_V4_Protobuf_Codec());
+	} else if (name == "ttn-v3") {
+		return std::unique_ptr<Payload_Codec>(new TTN_V3_Codec());
+	}
+
+	return nullptr;
+}
+
+const char* Payload_Codec::Get_Names()
+{
+	return "chirpstack-v3, chirpstack-v4, chirpstack-v4-protobuf, ttn-v3";
+}
+
+/* JSON codecs */
+
+// copies zero-terminated string; returns pointer past the last written char
+static char* Write_String(char* out, const char* str)
+{
+	const size_t len = strlen(str);
+	memcpy(out, str, len);
+	return out + len;
+}
+
+// writes decimal representation of value; returns pointer past the last written char
+static char* Write_Decimal(char* out, uint64_t value)
+{
+	char digits[20];
+	size_t len = 0;
+
+	do {
+		digits[len++] = static_cast<char>('0' + (value % 10));
+		value /= 10;
+	} while (value != 0);
+
+	while (len > 0) {
+		*out++ = digits[--len];
+	}
+
+	return out;
+}
+
+Json_Payload_Codec::Json_Payload_Codec(const char* uplinkObject, const char* portKey, const char* fCntKey, const char* dataKey)
+	: mUplinkObject(uplinkObject), mPortKey(portKey), mFCntKey(fCntKey), mDataKey(dataKey)
+{
+	//
+}
+
+void Json_Payload_Codec::Prepare_Downlink(std::vector<char>& buffer, const std::string& devEui, uint16_t port, size_t frameLen, size_t& framePos) const
+{
+	const size_t dataLen = Base64::Encoded_Length(frameLen);
+	const size_t capacity = Max_Head_Length + devEui.length() + dataLen + strlen(Get_Tail());
+
+	if (buffer.size() < capacity) {
+		buffer.resize(capacity);
+	}
+
+	const size_t dataPos = static_cast<size_t>(Write_Head(buffer.data(), devEui, port) - buffer.data());
+
+	// raw frame goes to the end of base64 area, so it could be encoded in place
+	framePos = dataPos + dataLen - frameLen;
+}
+
+size_t Json_Payload_Codec::Finish_Downlink(std::vector<char>& buffer, size_t framePos, size_t frameLen) const
+{
+	const size_t dataPos = framePos + frameLen - Base64::Encoded_Length(frameLen);
+
+	char* out = Base64::Encode_To(buffer.data() + dataPos, reinterpret_cast<const uint8_t*>(buffer.data() + framePos), frameLen);
+	out = Write_String(out, Get_Tail());
+
+	return static_cast<size_t>(out - buffer.data());
+}
+
+bool Json_Payload_Codec::Decode_Uplink(const std::string& message, uint16_t& port, uint32_t& fCnt, std::vector<uint8_t>& frame) const
+{
+	std::string err;
+	const json11::Json parsedMsg = json11::Json::parse(message, err);
+
+	if (!err.empty()) {
+		return false;
+	}
+
+	const json11::Json& uplink = (mUplinkObject != nullptr) ? parsedMsg[mUplinkObject] : parsedMsg;
+
+	port = 0;
+	fCnt = static_cast<uint32_t>(uplink[mFCntKey].number_value());
+	frame.clear();
+
+	// uplinks without payload (e.g. just MAC commands) carry no frame
+	if (!uplink[mDataKey].is_string()) {
+		return true;
+	}
+
+	port = static_cast<uint16_t>(uplink[mPortKey].int_value());
+	Base64::Decode(frame, uplink[mDataKey].string_value());
+
+	return true;
+}
+
+ChirpStack_V3_Codec::ChirpStack_V3_Codec()
+	: Json_Payload_Codec(nullptr, "fPort", "fCnt", "data")
+{
+	//
+}
+
+char* ChirpStack_V3_Codec::Write_Head(char* out, const std::string& devEui, uint16_t port) const
+{
+	// {"reference": "<time>", "confirmed": false, "fPort": <port>, "data": "<base64>"}
+	out = Write_String(out, "{\"reference\": \"");
+	out = Write_Decimal(out, static_cast<uint64_t>(time(nullptr)));
+	out = Write_String(out, "\", \"confirmed\": false, \"fPort\": ");
+	out = Write_Decimal(out, port);
+	return Write_String(out, ", \"data\": \"");
+}
+
+const char* ChirpStack_V3_Codec::Get_Tail() const
+{
+	return "\"}";
+}
+
+ChirpStack_V4_Codec::ChirpStack_V4_Codec()
+	: Json_Payload_Codec(nullptr, "fPort", "fCnt", "data")
+{
+	//
+}
+
+char* ChirpStack_V4_Codec::Write_Head(char* out, const std::string& devEui, uint16_t port) const
+{
+	// {"devEui": "<deveui>", "confirmed": false, "fPort": <port>, "data": "<base64>"}
+	out = Write_String(out, "{\"devEui\": \"");
+	out = std::copy(devEui.begin(), devEui.end(), out);
+	out = Write_String(out, "\", \"confirmed\": false, \"fPort\": ");
+	out = Write_Decimal(out, port);
+	return Write_String(out, ", \"data\": \"");
+}
+
+const char* ChirpStack_V4_Codec::Get_Tail() const
+{
+	return "\"}";
+}
+
+TTN_V3_Codec::TTN_V3_Codec()
+	: Json_Payload_Codec("uplink_message", "f_port", "f_cnt", "frm_payload")
+{
+	//
+}
+
+char* TTN_V3_Codec::Write_Head(char* out, const std::string& devEui, uint16_t port) const
+{
+	// {"downlinks": [{"f_port": <port>, "priority": "NORMAL", "confirmed": false, "frm_payload": "<base64>"}]}
+	out = Write_String(out, "{\"downlinks\": [{\"f_port\": ");
+	out = Write_Decimal(out, port);
+	return Write_String(out, ", \"priority\": \"NORMAL\", \"confirmed\": false, \"frm_payload\": \"");
+}
+
+const char* TTN_V3_Codec::Get_Tail() const
+{
+	return "\"}]}";
+}
+
+/* protobuf codec */
+
+// protobuf wire types
+static constexpr uint32_t Wire_Varint = 0;
+static constexpr uint32_t Wire_Fixed64 = 1;
+static constexpr uint32_t Wire_Length_Delimited = 2;
+static constexpr uint32_t Wire_Fixed32 = 5;
+
+// api.DeviceQueueItem fields
+static constexpr uint32_t Queue_Item_Dev_Eui = 2;
+static constexpr uint32_t Queue_Item_F_Port = 4;
+static constexpr uint32_t Queue_Item_Data = 5;
+
+// integration.UplinkEvent fields
+static constexpr uint32_t Uplink_Event_F_Cnt = 7;
+static constexpr uint32_t Uplink_Event_F_Port = 8;
+static constexpr uint32_t Uplink_Event_Data = 10;
+
+// upper bound of downlink message length, not counting DevEUI and frame
+static constexpr size_t Max_Queue_Item_Overhead = 32;
+
+// writes base 128 varint; returns pointer past the last written byte
+static char* Write_Varint(char* out, uint64_t value)
+{
+	while (value >= 0x80) {
+		*out++ = static_cast<char>((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+
+	*out++ = static_cast<char>(value);
+
+	return out;
+}
+
+// writes field key; returns pointer past the last written byte
+static char* Write_Key(char* out, uint32_t field, uint32_t wireType)
+{
+	return Write_Varint(out, (static_cast<uint64_t>(field) << 3) | wireType);
+}
+
+// reads base 128 varint; returns false if the input ends before the varint does
+static bool Read_Varint(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+{
+	value = 0;
+
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		if (pos >= end) {
+			return false;
+		}
+
+		const uint8_t byte = *pos++;
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// reads length of length-delimited field; returns false if the field does not fit into input
+static bool Read_Length(const uint8_t*& pos, const uint8_t* end, size_t& length)
+{
+	uint64_t value;
+
+	if (!Read_Varint(pos, end, value) || value > static_cast<uint64_t>(end - pos)) {
+		return false;
+	}
+
+	length = static_cast<size_t>(value);
+
+	return true;
+}
+
+// skips value of field of given wire type; returns false on unsupported type or truncated input
+static bool Skip_Field(const uint8_t*& pos, const uint8_t* end, uint32_t wireType)
+{
+	uint64_t value;
+	size_t length;
+
+	switch (wireType) {
+		case Wire_Varint:
+			return Read_Varint(pos, end, value);
+		case Wire_Fixed64:
+			length = 8;
+			break;
+		case Wire_Length_Delimited:
+			if (!Read_Length(pos, end, length)) {
+				return false;
+			}
+			break;
+		case Wire_Fixed32:
+			length = 4;
+			break;
+		default:
+			// groups are deprecated and not used by any of the messages
+			return false;
+	}
+
+	if (length > static_cast<size_t>(end - pos)) {
+		return false;
+	}
+
+	pos += length;
+
+	return true;
+}
+
+void ChirpStack_V4_Protobuf_Codec::Prepare_Downlink(std::vector<char>& buffer, const std::string& devEui, uint16_t port, size_t frameLen, size_t& framePos) const
+{
+	const size_t capacity = Max_Queue_Item_Overhead + devEui.length() + frameLen;
+
+	if (buffer.size() < capacity) {
+		buffer.resize(capacity);
+	}
+
+	char* out = buffer.data();
+
+	// confirmed = false is the default, so it is not serialized at all
+	out = Write_Key(out, Queue_Item_Dev_Eui, Wire_Length_Delimited);
+	out = Write_Varint(out, devEui.length());
+	out = std::copy(devEui.begin(), devEui.end(), out);
+
+	out = Write_Key(out, Queue_Item_F_Port, Wire_Varint);
+	out = Write_Varint(out, port);
+
+	out = Write_Key(out, Queue_Item_Data, Wire_Length_Delimited);
+	out = Write_Varint(out, frameLen);
+
+	framePos = static_cast<size_t>(out - buffer.data());
+}
+
+size_t ChirpStack_V4_Protobuf_Codec::Finish_Downlink(std::vector<char>& buffer, size_t framePos, size_t frameLen) const
+{
+	// the frame is the last field, already in place
+	return framePos + frameLen;
+}
+
+bool ChirpStack_V4_Protobuf_Codec::Decode_Uplink(const std::string& message, uint16_t& port, uint32_t& fCnt, std::vector<uint8_t>& frame) const
+{
+	const uint8_t* pos = reinterpret_cast<const uint8_t*>(message.data());
+	const uint8_t* end = pos + message.length();
+	uint64_t key, fPort = 0, counter = 0;
+	bool hasData = false;
+
+	port = 0;
+	fCnt = 0;
+	frame.clear();
+
+	while (pos < end) {
+		if (!Read_Varint(pos, end, key)) {
+			return false;
+		}
+
+		const uint32_t field = static_cast<uint32_t>(key >> 3);
+		const uint32_t wireType = static_cast<uint32_t>(key & 0x07);
+
+		if (field == Uplink_Event_F_Port && wireType == Wire_Varint) {
+			if (!Read_Varint(pos, end, fPort)) {
+				return false;
+			}
+		} else if (field == Uplink_Event_F_Cnt && wireType == Wire_Varint) {
+			if (!Read_Varint(pos, end, counter)) {
+				return false;
+			}
+		} else if (field == Uplink_Event_Data && wireType == Wire_Length_Delimited) {
+			size_t length;
+			if (!Read_Length(pos, end, length)) {
+				return false;
+			}
+
+			frame.assign(pos, pos + length);
+			pos += length;
+			hasData = true;
+		} else if (!Skip_Field(pos, end, wireType)) {
+			return false;
+		}
+	}
+
+	fCnt = static_cast<uint32_t>(counter);
+
+	// uplinks without payload carry no frame
+	if (hasData && fPort <= 0xFFFF) {
+		port = static_cast<uint16_t>(fPort);
+	}
+
+	return true;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file    payload_codec.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains network server payload codecs
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+/*
+ * Network server payload codec - builds downlink messages and reads uplink messages of one integration format
+ */
+class Payload_Codec
+{
+	public:
+		virtual ~Payload_Codec() = default;
+
+		// writes downlink message of given node up to the frame to buffer (growing it as needed); retrieves position, where raw frame of given length has to be written
+		virtual void Prepare_Downlink(std::vector<char>& buffer, const std::string& devEui, uint16_t port, size_t frameLen, size_t& framePos) const = 0;
+		// completes downlink message, which frame has been written to position given by Prepare_Downlink; returns message length
+		virtual size_t Finish_Downlink(std::vector<char>& buffer, size_t framePos, size_t frameLen) const = 0;
+
+		// decodes uplink message; port is 0 if the message carries no frame, frame counter is 0 if not present; returns false if the message is malformed
+		virtual bool Decode_Uplink(const std::string& message, uint16_t& port, uint32_t& fCnt, std::vector<uint8_t>& frame) const = 0;
+
+		// creates codec of given name; returns nullptr if not known
+		static std::unique_ptr<Payload_Codec> Create(const std::string& name);
+		// retrieves names of all codecs, for error messages
+		static const char* Get_Names();
+};
+
+/*
+ * Base of JSON codecs - the frame is base64 encoded in place as the last string of downlink message
+ */
+class Json_Payload_Codec : public Payload_Codec
+{
+	private:
+		// object of uplink message containing port and data; top-level object if nullptr
+		const char* mUplinkObject;
+		// key of uplink port
+		const char* mPortKey;
+		// key of uplink frame counter
+		const char* mFCntKey;
+		// key of uplink base64 data
+		const char* mDataKey;
+
+	protected:
+		// upper bound of downlink message head length, not counting DevEUI
+		static constexpr size_t Max_Head_Length = 160;
+
+		// writes downlink message head, ending with opening quote of base64 data; returns pointer past the last written char
+		virtual char* Write_Head(char* out, const std::string& devEui, uint16_t port) const = 0;
+		// retrieves downlink message tail, following the base64 data
+		virtual const char* Get_Tail() const = 0;
+
+	public:
+		Json_Payload_Codec(const char* uplinkObject, const char* portKey, const char* fCntKey, const char* dataKey);
+
+		virtual void Prepare_Downlink(std::vector<char>& buffer, const std::string& devEui, uint16_t port, size_t frameLen, size_t& framePos) const override;
+		virtual size_t Finish_Downlink(std::vector<char>& buffer, size_t framePos, size_t frameLen) const override;
+		virtual bool Decode_Uplink(const std::string& message, uint16_t& port, uint32_t& fCnt, std::vector<uint8_t>& frame) const override;
+};
+
+/*
+ * ChirpStack v3 application server JSON
+ */
+class ChirpStack_V3_Codec final : public Json_Payload_Codec
+{
+	protected:
+		virtual char* Write_Head(char* out, const std::string& devEui, uint16_t port) const override;
+		virtual const char* Get_Tail() const override;
+
+	public:
+		ChirpStack_V3_Codec();
+};
+
+/*
+ * ChirpStack v4 JSON (event/up and command/down)
+ */
+class ChirpStack_V4_Codec final : public Json_Payload_Codec
+{
+	protected:
+		virtual char* Write_Head(char* out, const std::string& devEui, uint16_t port) const override;
+		virtual const char* Get_Tail() const override;
+
+	public:
+		ChirpStack_V4_Codec();
+};
+
+/*
+ * The Things Stack (TTN) v3 JSON (up and down/push)
+ */
+class TTN_V3_Codec final : public Json_Payload_Codec
+{
+	protected:
+		virtual char* Write_Head(char* out, const std::string& devEui, uint16_t port) const override;
+		virtual const char* Get_Tail() const override;
+
+	public:
+		TTN_V3_Codec();
+};
+
+/*
+ * ChirpStack v4 protobuf - uplinks are integration.UplinkEvent, downlinks are api.DeviceQueueItem;
+ * the frame is carried as raw bytes, so neither JSON nor base64 is involved
+ */
+class ChirpStack_V4_Protobuf_Codec final : public Payload_Codec
+{
+	public:
+		virtual void Prepare_Downlink(std::vector<char>& buffer, const std::string& devEui, uint16_t port, size_t frameLen, size_t& framePos) const override;
+		virtual size_t Finish_Downlink(std::vector<char>& buffer, size_t framePos, size_t frameLen) const override;
+		virtual bool Decode_Uplink(const std::string& message, uint16_t& port, uint32_t& fCnt, std::vector<uint8_t>& frame) const override;
+};
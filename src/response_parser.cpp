@@ -0,0 +1,311 @@
+/**
+ * @file    response_parser.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of bounds-checked parser of remote terminal responses
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <sstream>
+#include <iomanip>
+
+#include "response_parser.h"
+#include "command_schema.h"
+#include "terminal.h"
+
+// reads value of given type from the start of span; returns false if the span is too short
+template<typename T>
+static bool Read_Value(const Byte_Span& span, size_t offset, T& out)
+{
+	if (span.length < offset + sizeof(T)) {
+		return false;
+	}
+
+	memcpy(&out, span.data + offset, sizeof(T));
+	return true;
+}
+
+Byte_Span::Byte_Span(const uint8_t* spanData, size_t spanLength)
+	: data(spanData), length(spanLength)
+{
+	//
+}
+
+Byte_Span::Byte_Span(const std::vector<uint8_t>& bytes)
+	: data(bytes.data()), length(bytes.size())
+{
+	//
+}
+
+Byte_Span Byte_Span::Sub(size_t offset, size_t count) const
+{
+	return Byte_Span(data + offset, count);
+}
+
+bool Command_Response_View::As_Bool(bool& out) const
+{
+	uint8_t raw;
+	if (!Read_Value(value, 0, raw)) {
+		return false;
+	}
+
+	out = (raw == TRUE);
+	return true;
+}
+
+bool Command_Response_View::As_Byte(uint8_t& out) const
+{
+	return Read_Value(value, 0, out);
+}
+
+bool Command_Response_View::As_Int32(int32_t& out) const
+{
+	return Read_Value(value, 0, out);
+}
+
+bool Command_Response_View::As_Uint32(uint32_t& out) const
+{
+	return Read_Value(value, 0, out);
+}
+
+bool Command_Response_View::As_Int32_Pair(int32_t& first, int32_t& second) const
+{
+	return Read_Value(value, offsetof(ketCube_terminal_paramSet_t, as_int32_pair.first), first)
+		&& Read_Value(value, offsetof(ketCube_terminal_paramSet_t, as_int32_pair.second), second);
+}
+
+bool Command_Response_View::As_Module_Id(ketCube_moduleID_t& out) const
+{
+	return Read_Value(value, offsetof(ketCube_terminal_paramSet_t, as_module_id.module_id), out);
+}
+
+bool Command_Response_View::As_String(const char*& str, size_t& strLength) const
+{
+	if (value.length == 0) {
+		return false;
+	}
+
+	str = reinterpret_cast<const char*>(value.data);
+
+	const void* terminator = memchr(value.data, 0, value.length);
+	strLength = (terminator != nullptr) ? static_cast<size_t>(static_cast<const uint8_t*>(terminator) - value.data) : value.length;
+
+	return true;
+}
+
+bool Command_Response_View::As_Byte_Array(Byte_Span& out) const
+{
+	constexpr size_t dataOffset = offsetof(ketCube_terminal_paramSet_t, as_byte_array.data);
+	constexpr size_t capacity = sizeof(std::declval<ketCube_terminal_paramSet_t>().as_byte_array.data);
+
+	uint8_t arrayLength;
+	if (!Read_Value(value, offsetof(ketCube_terminal_paramSet_t, as_byte_array.length), arrayLength) || arrayLength > capacity || value.length < dataOffset + arrayLength) {
+		return false;
+	}
+
+	out = value.Sub(dataOffset, arrayLength);
+	return true;
+}
+
+bool Response_Parser::Parse_Single(Byte_Span frame, Command_Response_View& response, std::string& error)
+{
+	// error code is mandatory, the value is optional
+	if (frame.length <= Terminal_Base::Response_Header_Length) {
+		error = "Response contains no error code";
+		return false;
+	}
+
+	const Byte_Span contents = frame.Sub(Terminal_Base::Response_Header_Length, frame.length - Terminal_Base::Response_Header_Length);
+
+	response.errorCode = static_cast<ketCube_terminal_command_errorCode_t>(contents.data[0]);
+	response.value = contents.Sub(1, contents.length - 1);
+
+	return true;
+}
+
+bool Response_Parser::Parse_Batch(Byte_Span frame, size_t maxResponses, std::vector<Command_Response_View>& responses, std::string& error)
+{
+	size_t pos;
+	bool valid = true;
+
+	responses.clear();
+
+	// the whole frame is walked first, so nothing is decoded from frame with any bad length
+	for (pos = Terminal_Base::Response_Header_Length; valid && pos < frame.length; ) {
+		const size_t len = frame.data[pos++];
+
+		if (len == 0) {
+			error = "Response " + std::to_string(responses.size() + 1) + " contains no error code";
+			valid = false;
+			break;
+		}
+
+		if (len > frame.length - pos) {
+			error = "Response " + std::to_string(responses.size() + 1) + " exceeds the frame (length " + std::to_string(len) + ", "
+				+ std::to_string(frame.length - pos) + " bytes left)";
+			valid = false;
+			break;
+		}
+
+		if (responses.size() >= maxResponses) {
+			error = "Received response for more than the length of pending command queue";
+			valid = false;
+			break;
+		}
+
+		Command_Response_View response;
+		response.errorCode = static_cast<ketCube_terminal_command_errorCode_t>(frame.data[pos]);
+		response.value = frame.Sub(pos + 1, len - 1);
+		responses.push_back(response);
+
+		pos += len;
+	}
+
+	if (!valid) {
+		responses.clear();
+	}
+
+	return valid;
+}
+
+bool Response_Parser::Format_Value(const Command_Response_View& response, const ketCube_terminal_cmd_t* command, const Command_Schema& schema, std::string& out, std::string& error)
+{
+	bool valid = false;
+
+	if (command->outputSetType == KETCUBE_TERMINAL_PARAMS_NONE) {
+		return false;
+	}
+
+	if (response.value.length > sizeof(ketCube_terminal_paramSet_t)) {
+		error = "Invalid value set retrieved (size = " + std::to_string(response.value.length) + ", expected max. size = " + std::to_string(sizeof(ketCube_terminal_paramSet_t)) + ")";
+		return false;
+	}
+
+	switch (command->outputSetType)
+	{
+		case KETCUBE_TERMINAL_PARAMS_BOOLEAN:
+		{
+			bool value;
+			if ((valid = response.As_Bool(value))) {
+				out = value ? "TRUE" : "FALSE";
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_STRING:
+		{
+			const char* str;
+			size_t strLength;
+			if ((valid = response.As_String(str, strLength))) {
+				out.assign(str, strLength);
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_INT32:
+		{
+			int32_t value;
+			if ((valid = response.As_Int32(value))) {
+				out = std::to_string(value);
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_UINT32:
+		{
+			uint32_t value;
+			if ((valid = response.As_Uint32(value))) {
+				out = std::to_string(value);
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_BYTE:
+		{
+			uint8_t value;
+			if ((valid = response.As_Byte(value))) {
+				out = std::to_string(static_cast<int>(value));
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_INT32_PAIR:
+		{
+			int32_t first, second;
+			if ((valid = response.As_Int32_Pair(first, second))) {
+				out = std::to_string(first) + ", " + std::to_string(second);
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_BYTE_ARRAY:
+		{
+			Byte_Span bytes;
+			if ((valid = response.As_Byte_Array(bytes))) {
+				std::ostringstream ostr;
+				for (size_t i = 0; i < bytes.length; i++) {
+					ostr << std::hex << std::setw(2) << std::setfill('0') << std::uppercase << static_cast<int>(bytes.data[i]);
+					if (i + 1 != bytes.length) {
+						ostr << "-";
+					}
+				}
+				out = ostr.str();
+			}
+			break;
+		}
+		case KETCUBE_TERMINAL_PARAMS_MODULEID:
+		{
+			ketCube_moduleID_t moduleId;
+			if ((valid = response.As_Module_Id(moduleId))) {
+				const char* moduleName = schema.Lookup_Module_Name(moduleId);
+				out = (moduleName != nullptr) ? moduleName : "invalid module";
+			}
+			break;
+		}
+		default:
+		{
+			out = "<unknown return type>";
+			return true;
+		}
+	}
+
+	if (!valid) {
+		error = "Invalid value set retrieved (size = " + std::to_string(response.value.length) + ", too short for the output type)";
+		return false;
+	}
+
+	return true;
+}
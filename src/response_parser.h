@@ -0,0 +1,109 @@
+/**
+ * @file    response_parser.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains bounds-checked parser of remote terminal responses
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "impl_bridge.h"
+
+struct Command_Schema;
+
+/*
+ * Read-only view of bytes within received frame
+ */
+struct Byte_Span
+{
+	const uint8_t* data = nullptr;
+	size_t length = 0;
+
+	Byte_Span() = default;
+	Byte_Span(const uint8_t* spanData, size_t spanLength);
+	Byte_Span(const std::vector<uint8_t>& bytes);
+
+	// retrieves part of span; bounds have to be validated by caller
+	Byte_Span Sub(size_t offset, size_t count) const;
+};
+
+/*
+ * Response of single command - error code and output value, viewed straight over the received frame
+ */
+struct Command_Response_View
+{
+	// error code reported by node
+	ketCube_terminal_command_errorCode_t errorCode = KETCUBE_TERMINAL_CMD_ERR_OK;
+	// output value; laid out as ketCube_terminal_paramSet_t, possibly shortened
+	Byte_Span value;
+
+	// typed accessors; return false if the value is too short for the type
+	bool As_Bool(bool& out) const;
+	bool As_Byte(uint8_t& out) const;
+	bool As_Int32(int32_t& out) const;
+	bool As_Uint32(uint32_t& out) const;
+	bool As_Int32_Pair(int32_t& first, int32_t& second) const;
+	bool As_Module_Id(ketCube_moduleID_t& out) const;
+	// string ends at the first zero byte or at the end of value, whichever comes first
+	bool As_String(const char*& str, size_t& strLength) const;
+	bool As_Byte_Array(Byte_Span& out) const;
+};
+
+/*
+ * Parser of response frames; validates every length against the frame before any response is yielded,
+ * the responses point into the frame, so it has to outlive them
+ */
+class Response_Parser
+{
+	public:
+		// parses response of single command following the header; returns false with error message if it is malformed
+		static bool Parse_Single(Byte_Span frame, Command_Response_View& response, std::string& error);
+		// parses responses of batch following the header, at most maxResponses of them; returns false with error message if it is malformed
+		static bool Parse_Batch(Byte_Span frame, size_t maxResponses, std::vector<Command_Response_View>& responses, std::string& error);
+
+		// formats value according to output type of command, module names are taken from schema of the node;
+		// returns false if the command has no output, error is set if the value is malformed
+		static bool Format_Value(const Command_Response_View& response, const ketCube_terminal_cmd_t* command, const Command_Schema& schema, std::string& out, std::string& error);
+};
@@ -0,0 +1,116 @@
+/**
+ * @file    rtt_estimator.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains round-trip time estimator implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtt_estimator.h"
+
+// gain of SRTT (alpha) and RTTVAR (beta), RTTVAR multiplier (K) as defined in RFC 6298
+static const double RTT_Alpha = 1.0 / 8.0;
+static const double RTT_Beta = 1.0 / 4.0;
+static const double RTT_K = 4.0;
+// maximum backoff shift, so the RTO could not overflow
+static const unsigned int RTT_Max_Backoff_Shift = 16;
+
+RTT_Estimator::RTT_Estimator(long initialRtoMs, long minRtoMs, long maxRtoMs)
+	: mSrtt(0.0), mRttVar(0.0), mHasSample(false), mBackoffShift(0), mInitialRto(initialRtoMs), mMinRto(minRtoMs), mMaxRto(std::max(minRtoMs, maxRtoMs))
+{
+	//
+}
+
+void RTT_Estimator::Add_Sample(long rttMs)
+{
+	const double r = static_cast<double>(rttMs);
+
+	if (!mHasSample) {
+		mSrtt = r;
+		mRttVar = r / 2.0;
+		mHasSample = true;
+	} else {
+		mRttVar = (1.0 - RTT_Beta) * mRttVar + RTT_Beta * std::fabs(mSrtt - r);
+		mSrtt = (1.0 - RTT_Alpha) * mSrtt + RTT_Alpha * r;
+	}
+
+	mBackoffShift = 0;
+}
+
+void RTT_Estimator::Backoff()
+{
+	if (mBackoffShift < RTT_Max_Backoff_Shift) {
+		mBackoffShift++;
+	}
+}
+
+void RTT_Estimator::Restore(double srttMs, double rttVarMs)
+{
+	mSrtt = srttMs;
+	mRttVar = rttVarMs;
+	mHasSample = true;
+	mBackoffShift = 0;
+}
+
+long RTT_Estimator::Get_RTO() const
+{
+	double rto = mHasSample ? (mSrtt + RTT_K * mRttVar) : static_cast<double>(mInitialRto);
+
+	rto *= static_cast<double>(1UL << mBackoffShift);
+
+	return static_cast<long>(std::min(static_cast<double>(mMaxRto), std::max(static_cast<double>(mMinRto), rto)));
+}
+
+bool RTT_Estimator::Has_Sample() const
+{
+	return mHasSample;
+}
+
+double RTT_Estimator::Get_SRTT() const
+{
+	return mSrtt;
+}
+
+double RTT_Estimator::Get_RTTVAR() const
+{
+	return mRttVar;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    rtt_estimator.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains round-trip time estimator for adaptive response timeouts
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Round-trip time estimator in the style of TCP (RFC 6298) - smoothed RTT and its variance
+ * determine the response timeout (RTO); timeouts back the RTO off exponentially
+ */
+class RTT_Estimator
+{
+	private:
+		// smoothed round-trip time in ms
+		double mSrtt;
+		// round-trip time variance in ms
+		double mRttVar;
+		// was there any sample yet?
+		bool mHasSample;
+		// current backoff shift (RTO is multiplied by 2^shift)
+		unsigned int mBackoffShift;
+
+		// RTO used before any sample is taken
+		long mInitialRto;
+		// lower RTO bound
+		long mMinRto;
+		// upper RTO bound
+		long mMaxRto;
+
+	public:
+		RTT_Estimator(long initialRtoMs = 60000, long minRtoMs = 5000, long maxRtoMs = 600000);
+
+		// adds measured round-trip time; resets backoff
+		void Add_Sample(long rttMs);
+		// backs off RTO after timeout
+		void Backoff();
+		// restores previously measured state (e.g. from state store)
+		void Restore(double srttMs, double rttVarMs);
+
+		// retrieves current response timeout in ms
+		long Get_RTO() const;
+		// was there any sample yet?
+		bool Has_Sample() const;
+		// retrieves smoothed round-trip time in ms
+		double Get_SRTT() const;
+		// retrieves round-trip time variance in ms
+		double Get_RTTVAR() const;
+};
@@ -0,0 +1,397 @@
+/**
+ * @file    schema_registry.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of runtime-loadable command tree schemas
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstring>
+
+#include "schema_registry.h"
+
+namespace {
+
+	constexpr char Schema_Magic[4] = { 'K', 'R', 'T', 'S' };
+	constexpr uint16_t Schema_Format_Version = 1;
+	// list reference of entries without sublist; name offset of list terminator
+	constexpr uint32_t Schema_None = 0xFFFFFFFF;
+
+#pragma pack(push, 1)
+
+	/*
+	 * Schema file header; followed by entries, modules and string table
+	 */
+	struct Schema_File_Header
+	{
+		char magic[4];
+		uint16_t formatVersion;
+		uint16_t coreApiVersion;
+		uint32_t entryCount;
+		uint32_t moduleCount;
+		uint32_t stringsSize;
+	};
+
+	/*
+	 * Command tree entry record; lists are stored contiguously, root list first
+	 */
+	struct Schema_File_Entry
+	{
+		uint32_t nameOffset;
+		uint32_t descrOffset;
+		uint32_t subListIndex;
+		uint16_t flags;
+		uint8_t paramSetType;
+		uint8_t outputSetType;
+		uint16_t moduleId;
+		uint16_t reserved;
+	};
+
+	/*
+	 * Module record
+	 */
+	struct Schema_File_Module
+	{
+		uint32_t nameOffset;
+		uint16_t id;
+		uint16_t reserved;
+	};
+
+#pragma pack(pop)
+
+	uint16_t Pack_Flags(const ketCube_terminal_command_flags_t& flags)
+	{
+		return static_cast<uint16_t>(
+			(flags.isGroup << 0) | (flags.isGeneric << 1) | (flags.isShowCmd << 2) | (flags.isSetCmd << 3) |
+			(flags.isRemote << 4) | (flags.isLocal << 5) | (flags.isEEPROM << 6) | (flags.isRAM << 7));
+	}
+
+	ketCube_terminal_command_flags_t Unpack_Flags(uint16_t packed)
+	{
+		ketCube_terminal_command_flags_t flags{};
+
+		flags.isGroup = (packed >> 0) & 1;
+		flags.isGeneric = (packed >> 1) & 1;
+		flags.isShowCmd = (packed >> 2) & 1;
+		flags.isSetCmd = (packed >> 3) & 1;
+		flags.isRemote = (packed >> 4) & 1;
+		flags.isLocal = (packed >> 5) & 1;
+		flags.isEEPROM = (packed >> 6) & 1;
+		flags.isRAM = (packed >> 7) & 1;
+
+		return flags;
+	}
+
+	/*
+	 * Helper for building schema file contents
+	 */
+	class Schema_Writer
+	{
+		public:
+			std::vector<Schema_File_Entry> entries;
+			std::vector<Schema_File_Module> modules;
+			std::vector<char> strings;
+
+			uint32_t Add_String(const char* str)
+			{
+				const uint32_t offset = static_cast<uint32_t>(strings.size());
+				strings.insert(strings.end(), str, str + strlen(str) + 1);
+				return offset;
+			}
+
+			// adds list and its sublists; returns index of the first list entry
+			uint32_t Add_List(const ketCube_terminal_cmd_t* list)
+			{
+				size_t count = 0;
+				while (list[count].cmd != nullptr) {
+					count++;
+				}
+
+				const uint32_t first = static_cast<uint32_t>(entries.size());
+				entries.resize(entries.size() + count + 1);
+
+				for (size_t i = 0; i < count; i++) {
+					Schema_File_Entry rec{};
+
+					rec.nameOffset = Add_String(list[i].cmd);
+					rec.descrOffset = Add_String(list[i].descr != nullptr ? list[i].descr : "");
+					rec.subListIndex = Schema_None;
+					rec.flags = Pack_Flags(list[i].flags);
+					rec.paramSetType = static_cast<uint8_t>(list[i].paramSetType);
+					rec.outputSetType = static_cast<uint8_t>(list[i].outputSetType);
+					rec.moduleId = list[i].moduleId;
+
+					if (list[i].flags.isGroup && list[i].settingsPtr.subCmdList != nullptr) {
+						rec.subListIndex = Add_List(list[i].settingsPtr.subCmdList);
+					}
+
+					entries[first + i] = rec;
+				}
+
+				Schema_File_Entry& terminator = entries[first + count];
+				terminator = {};
+				terminator.nameOffset = Schema_None;
+				terminator.descrOffset = Schema_None;
+				terminator.subListIndex = Schema_None;
+
+				return first;
+			}
+	};
+}
+
+Schema_Registry::Schema_Registry()
+{
+	const Command_Schema& builtIn = Command_Schema::Built_In();
+	mSchemas[builtIn.coreApiVersion] = &builtIn;
+}
+
+bool Schema_Registry::Load(const std::string& path)
+{
+	std::unique_ptr<Loaded_Schema> loaded = std::make_unique<Loaded_Schema>();
+
+	if (!loaded->file.Open(path)) {
+		std::cerr << "Could not open schema file " << path << std::endl;
+		return false;
+	}
+
+	const uint8_t* data = loaded->file.Get_Data();
+	const size_t size = loaded->file.Get_Size();
+
+	Schema_File_Header hdr;
+	if (size < sizeof(hdr)) {
+		std::cerr << "Schema file " << path << " is truncated" << std::endl;
+		return false;
+	}
+
+	memcpy(&hdr, data, sizeof(hdr));
+
+	if (memcmp(hdr.magic, Schema_Magic, sizeof(Schema_Magic)) != 0 || hdr.formatVersion != Schema_Format_Version) {
+		std::cerr << "File " << path << " is not a valid schema file" << std::endl;
+		return false;
+	}
+
+	const size_t entriesPos = sizeof(hdr);
+	const size_t modulesPos = entriesPos + static_cast<size_t>(hdr.entryCount) * sizeof(Schema_File_Entry);
+	const size_t stringsPos = modulesPos + static_cast<size_t>(hdr.moduleCount) * sizeof(Schema_File_Module);
+
+	if (hdr.entryCount == 0 || stringsPos + hdr.stringsSize != size || hdr.stringsSize == 0 || data[size - 1] != '\0') {
+		std::cerr << "Schema file " << path << " is corrupted" << std::endl;
+		return false;
+	}
+
+	// strings are used in-place; the string table is null-terminated, so every offset within it is a valid C string
+	char* strings = reinterpret_cast<char*>(const_cast<uint8_t*>(data + stringsPos));
+
+	loaded->entries.resize(hdr.entryCount);
+
+	for (uint32_t i = 0; i < hdr.entryCount; i++) {
+		Schema_File_Entry rec;
+		memcpy(&rec, data + entriesPos + i * sizeof(rec), sizeof(rec));
+
+		ketCube_terminal_cmd_t& entry = loaded->entries[i];
+		entry = {};
+
+		if (rec.nameOffset == Schema_None) {
+			continue;
+		}
+
+		if (rec.nameOffset >= hdr.stringsSize || rec.descrOffset >= hdr.stringsSize ||
+			(rec.subListIndex != Schema_None && rec.subListIndex >= hdr.entryCount)) {
+			std::cerr << "Schema file " << path << " is corrupted" << std::endl;
+			return false;
+		}
+
+		entry.cmd = strings + rec.nameOffset;
+		entry.descr = strings + rec.descrOffset;
+		entry.flags = Unpack_Flags(rec.flags);
+		entry.paramSetType = static_cast<ketCube_terminal_paramSetType_t>(rec.paramSetType);
+		entry.outputSetType = static_cast<ketCube_terminal_paramSetType_t>(rec.outputSetType);
+		entry.moduleId = rec.moduleId;
+		entry.settingsPtr.subCmdList = (rec.subListIndex != Schema_None) ? &loaded->entries[rec.subListIndex] : nullptr;
+	}
+
+	if (loaded->entries.back().cmd != nullptr) {
+		std::cerr << "Schema file " << path << " is corrupted" << std::endl;
+		return false;
+	}
+
+	for (uint32_t i = 0; i < hdr.moduleCount; i++) {
+		Schema_File_Module rec;
+		memcpy(&rec, data + modulesPos + i * sizeof(rec), sizeof(rec));
+
+		if (rec.nameOffset >= hdr.stringsSize) {
+			std::cerr << "Schema file " << path << " is corrupted" << std::endl;
+			return false;
+		}
+
+		loaded->schema.modules.push_back({ rec.id, strings + rec.nameOffset });
+	}
+
+	loaded->schema.coreApiVersion = hdr.coreApiVersion;
+	loaded->schema.root = &loaded->entries[0];
+
+	mSchemas[hdr.coreApiVersion] = &loaded->schema;
+	mLoaded.push_back(std::move(loaded));
+
+	return true;
+}
+
+bool Schema_Registry::Load_List(const std::string& paths)
+{
+	size_t start = 0;
+
+	while (start <= paths.size()) {
+		size_t end = paths.find(',', start);
+		if (end == std::string::npos) {
+			end = paths.size();
+		}
+
+		const std::string path = paths.substr(start, end - start);
+		if (!path.empty() && !Load(path)) {
+			return false;
+		}
+
+		start = end + 1;
+	}
+
+	return true;
+}
+
+const Command_Schema* Schema_Registry::Get(uint16_t coreApiVersion) const
+{
+	auto itr = mSchemas.find(coreApiVersion);
+	return (itr != mSchemas.end()) ? itr->second : nullptr;
+}
+
+const Command_Schema& Schema_Registry::Get_For_Node(const std::string& node) const
+{
+	uint16_t version;
+	if (Get_Node_Version(node, version)) {
+		const Command_Schema* schema = Get(version);
+		if (schema != nullptr) {
+			return *schema;
+		}
+	}
+
+	return Command_Schema::Built_In();
+}
+
+const Command_Schema* Schema_Registry::Get_Next(uint16_t coreApiVersion) const
+{
+	// probe from the newest version down, skipping the one that failed
+	for (auto itr = mSchemas.rbegin(); itr != mSchemas.rend(); ++itr) {
+		if (itr->first < coreApiVersion) {
+			return itr->second;
+		}
+	}
+
+	return nullptr;
+}
+
+size_t Schema_Registry::Get_Count() const
+{
+	return mSchemas.size();
+}
+
+void Schema_Registry::Set_Node_Version(const std::string& node, uint16_t coreApiVersion)
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+	mNodeVersions[node] = coreApiVersion;
+}
+
+bool Schema_Registry::Get_Node_Version(const std::string& node, uint16_t& coreApiVersion) const
+{
+	std::unique_lock<std::mutex> lck(mMtx);
+
+	auto itr = mNodeVersions.find(node);
+	if (itr == mNodeVersions.end()) {
+		return false;
+	}
+
+	coreApiVersion = itr->second;
+	return true;
+}
+
+bool Schema_Registry::Export(const std::string& path)
+{
+	const Command_Schema& builtIn = Command_Schema::Built_In();
+	Schema_Writer writer;
+
+	writer.Add_List(builtIn.root);
+
+	for (const Schema_Module& module : builtIn.modules) {
+		Schema_File_Module rec{};
+		rec.nameOffset = writer.Add_String(module.name);
+		rec.id = module.id;
+		writer.modules.push_back(rec);
+	}
+
+	Schema_File_Header hdr;
+	memcpy(hdr.magic, Schema_Magic, sizeof(Schema_Magic));
+	hdr.formatVersion = Schema_Format_Version;
+	hdr.coreApiVersion = builtIn.coreApiVersion;
+	hdr.entryCount = static_cast<uint32_t>(writer.entries.size());
+	hdr.moduleCount = static_cast<uint32_t>(writer.modules.size());
+	hdr.stringsSize = static_cast<uint32_t>(writer.strings.size());
+
+	const size_t size = sizeof(hdr) + writer.entries.size() * sizeof(Schema_File_Entry)
+		+ writer.modules.size() * sizeof(Schema_File_Module) + writer.strings.size();
+
+	Mapped_File file;
+	if (!file.Create(path, size)) {
+		std::cerr << "Could not create schema file " << path << std::endl;
+		return false;
+	}
+
+	uint8_t* target = file.Get_Writable_Data();
+
+	memcpy(target, &hdr, sizeof(hdr));
+	target += sizeof(hdr);
+	memcpy(target, writer.entries.data(), writer.entries.size() * sizeof(Schema_File_Entry));
+	target += writer.entries.size() * sizeof(Schema_File_Entry);
+	memcpy(target, writer.modules.data(), writer.modules.size() * sizeof(Schema_File_Module));
+	target += writer.modules.size() * sizeof(Schema_File_Module);
+	memcpy(target, writer.strings.data(), writer.strings.size());
+
+	file.Sync(false);
+	file.Close();
+
+	return true;
+}
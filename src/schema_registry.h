@@ -0,0 +1,109 @@
+/**
+ * @file    schema_registry.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains registry of runtime-loadable command tree schemas
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "command_schema.h"
+#include "mapped_file.h"
+
+/*
+ * Schema loaded from file; command tree entries point to strings in mapped file
+ */
+struct Loaded_Schema
+{
+	// mapped schema file
+	Mapped_File file;
+	// command tree entries; lists are terminated by entry with nullptr command
+	std::vector<ketCube_terminal_cmd_t> entries;
+	// schema view of loaded data
+	Command_Schema schema;
+};
+
+/*
+ * Registry of command tree schemas keyed by core API version; always contains built-in schema
+ */
+class Schema_Registry
+{
+	private:
+		// schemas loaded from files
+		std::vector<std::unique_ptr<Loaded_Schema>> mLoaded;
+		// all known schemas; core API version -> schema
+		std::map<uint16_t, const Command_Schema*> mSchemas;
+		// core API versions learned from nodes; node -> version
+		std::map<std::string, uint16_t> mNodeVersions;
+		// mutex guarding node versions
+		mutable std::mutex mMtx;
+
+	public:
+		Schema_Registry();
+
+		// loads schema from file; returns false on failure
+		bool Load(const std::string& path);
+		// loads schemas from comma-separated list of files; returns false if any of them fails
+		bool Load_List(const std::string& paths);
+
+		// retrieves schema of given core API version; nullptr if not known
+		const Command_Schema* Get(uint16_t coreApiVersion) const;
+		// retrieves schema to be used for given node (learned one or built-in)
+		const Command_Schema& Get_For_Node(const std::string& node) const;
+		// retrieves schema to probe after given one failed with core API mismatch; nullptr if none left
+		const Command_Schema* Get_Next(uint16_t coreApiVersion) const;
+		// retrieves number of known schemas
+		size_t Get_Count() const;
+
+		// stores core API version the node responded to
+		void Set_Node_Version(const std::string& node, uint16_t coreApiVersion);
+		// retrieves core API version learned for node; returns false if not known
+		bool Get_Node_Version(const std::string& node, uint16_t& coreApiVersion) const;
+
+		// exports schema compiled into the application to file; returns false on failure
+		static bool Export(const std::string& path);
+};
@@ -0,0 +1,387 @@
+/**
+ * @file    script_compiler.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains offline script compiler and compiled script reader implementation
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstring>
+
+#include "script_compiler.h"
+
+static_assert(sizeof(Compiled_Script_Header) == 20, "Unexpected compiled script header size");
+static_assert(sizeof(Compiled_Record_Header) == 12, "Unexpected compiled record header size");
+
+static const char Compiled_Script_Magic[4] = { 'K', 'R', 'T', 'C' };
+
+constexpr uint16_t Script_Compiler::Format_Version;
+
+/*
+ * Script unit - a single packet to be sent (single command or batch)
+ */
+struct Script_Unit
+{
+	ketCube_terminal_command_opcode_t opcode;
+	std::vector<std::pair<size_t, std::string>> commands;	// line number, command
+};
+
+// splits script into units, the same way Terminal_Handler::Run does
+static bool Split_Script(Line_Reader& input, size_t maxBatchCommands, std::vector<Script_Unit>& units, std::ostream& errOutput)
+{
+	std::string inStr;
+	size_t lineNo = 0;
+	bool batchMode = false;
+	bool success = true;
+	Script_Unit batch;
+
+	while (input.Next(inStr)) {
+		lineNo++;
+
+		if (inStr.length() == 0) {
+			continue;
+		}
+
+		if (inStr[0] == '!') {
+
+			if (inStr == "!batch") {
+				if (batchMode) {
+					errOutput << "line " << lineNo << ": batch mode already started" << std::endl;
+					success = false;
+				}
+				batchMode = true;
+				batch.opcode = KETCUBE_TERMINAL_OPCODE_BATCH;
+				batch.commands.clear();
+			} else if (inStr == "!commit") {
+				if (!batchMode || batch.commands.empty()) {
+					errOutput << "line " << lineNo << ": no batch commands to commit" << std::endl;
+					success = false;
+				} else {
+					units.push_back(batch);
+				}
+				batchMode = false;
+			} else if (inStr == "!abort") {
+				batchMode = false;
+			} else {
+				errOutput << "line " << lineNo << ": unknown control command: " << inStr << std::endl;
+				success = false;
+			}
+
+			continue;
+		}
+
+		if (batchMode) {
+			if (batch.commands.size() >= maxBatchCommands) {
+				errOutput << "line " << lineNo << ": maximum number of batch commands reached: " << maxBatchCommands << std::endl;
+				success = false;
+				continue;
+			}
+			batch.commands.emplace_back(lineNo, inStr);
+		} else {
+			units.push_back({ KETCUBE_TERMINAL_OPCODE_CMD, { { lineNo, inStr } } });
+		}
+	}
+
+	if (batchMode) {
+		errOutput << "line " << lineNo << ": batch not committed at end of script" << std::endl;
+		success = false;
+	}
+
+	return success;
+}
+
+// encodes single unit and appends its record to target
+static bool Encode_Unit(const Terminal_Base& terminal, const Command_Tree_Index& index, const Script_Unit& unit, std::vector<uint8_t>& target, std::ostream& errOutput)
+{
+	Terminal_Command_Buffer cmdBuf;
+	std::vector<uint32_t> refs;
+	std::vector<uint8_t> packet;
+	ketCube_terminal_cmd_t* command;
+	Compiled_Record_Header hdr;
+
+	cmdBuf.Set_Opcode(unit.opcode);
+	cmdBuf.Set_Flag_16bit_Module_ID(false);
+	cmdBuf.Set_Sequence_No(0);
+
+	for (auto& cmd : unit.commands) {
+
+		Terminal_Command_Block cmdBlock;
+
+		if (!terminal.Encode_Command(cmd.second, cmdBlock, command)) {
+			errOutput << "line " << cmd.first << ": unknown command: " << cmd.second << std::endl;
+			return false;
+		}
+
+		cmdBuf.Set_Flag_16bit_Module_ID(cmdBuf.Has_Flag_16bit_Module_Id() || (cmdBlock.Get_Module_ID() > 0xFF));
+		if (!cmdBuf.Append(cmdBlock)) {
+			errOutput << "line " << cmd.first << ": packet does not fit into single frame: " << cmd.second << std::endl;
+			return false;
+		}
+		refs.push_back(index.Get_Index(command));
+	}
+
+	cmdBuf.Serialize(packet);
+
+	if (packet.size() > 0xFF) {
+		errOutput << "line " << unit.commands[0].first << ": packet too long (" << packet.size() << " bytes)" << std::endl;
+		return false;
+	}
+
+	const size_t unpadded = sizeof(hdr) + refs.size() * sizeof(uint32_t) + packet.size();
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.recordSize = static_cast<uint16_t>((unpadded + 3) & ~static_cast<size_t>(3));
+	hdr.packetLen = static_cast<uint8_t>(packet.size());
+	hdr.refCount = static_cast<uint8_t>(refs.size());
+	hdr.sourceLine = static_cast<uint32_t>(unit.commands[0].first);
+
+	// when sending "reload", the node has no chance to send back response
+	if (unit.opcode == KETCUBE_TERMINAL_OPCODE_CMD && unit.commands[0].second == "reload") {
+		hdr.flags |= Compiled_Record_No_Response;
+	}
+
+	const size_t origSize = target.size();
+	target.resize(origSize + hdr.recordSize, 0);
+
+	uint8_t* dst = target.data() + origSize;
+	memcpy(dst, &hdr, sizeof(hdr));
+	dst += sizeof(hdr);
+	memcpy(dst, refs.data(), refs.size() * sizeof(uint32_t));
+	dst += refs.size() * sizeof(uint32_t);
+	memcpy(dst, packet.data(), packet.size());
+
+	return true;
+}
+
+Script_Compiler::Script_Compiler(const Terminal_Base& terminal, const Command_Tree_Index& index, long maxBatchCmds)
+	: mTerminal(terminal), mIndex(index), mMaxBatchCommands(static_cast<size_t>(maxBatchCmds))
+{
+	//
+}
+
+bool Script_Compiler::Compile(Line_Reader& input, const std::string& outputPath, std::ostream& errOutput, size_t threadCount) const
+{
+	std::vector<Script_Unit> units;
+
+	if (!Split_Script(input, mMaxBatchCommands, units, errOutput)) {
+		return false;
+	}
+
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = std::max<size_t>(1, std::min(threadCount, units.size()));
+
+	// every thread encodes contiguous range of units, so the concatenated output keeps script order
+	std::vector<std::vector<uint8_t>> blobs(threadCount);
+	std::vector<std::ostringstream> errors(threadCount);
+	std::vector<char> results(threadCount, 1);
+	std::vector<std::thread> workers;
+
+	const size_t perThread = (units.size() + threadCount - 1) / threadCount;
+
+	for (size_t t = 0; t < threadCount; t++) {
+		workers.emplace_back([&, t]() {
+			const size_t first = t * perThread;
+			const size_t last = std::min(units.size(), first + perThread);
+
+			for (size_t i = first; i < last; i++) {
+				if (!Encode_Unit(mTerminal, mIndex, units[i], blobs[t], errors[t])) {
+					results[t] = 0;
+				}
+			}
+		});
+	}
+
+	bool success = true;
+
+	for (size_t t = 0; t < threadCount; t++) {
+		workers[t].join();
+
+		errOutput << errors[t].str();
+		success = success && (results[t] != 0);
+	}
+
+	if (!success) {
+		return false;
+	}
+
+	Compiled_Script_Header hdr;
+	memcpy(hdr.magic, Compiled_Script_Magic, sizeof(hdr.magic));
+	hdr.formatVersion = Format_Version;
+	hdr.coreApiVersion = KETCUBE_MODULEID_CORE_API;
+	hdr.treeFingerprint = mIndex.Get_Fingerprint();
+	hdr.recordCount = static_cast<uint32_t>(units.size());
+	hdr.dataSize = 0;
+	for (auto& blob : blobs) {
+		hdr.dataSize += static_cast<uint32_t>(blob.size());
+	}
+
+	std::ofstream outFs(outputPath, std::ios::binary | std::ios::trunc);
+	if (!outFs.is_open()) {
+		errOutput << "Could not open output file: " << outputPath << std::endl;
+		return false;
+	}
+
+	outFs.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+	for (auto& blob : blobs) {
+		outFs.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+	}
+
+	return outFs.good();
+}
+
+Compiled_Script::Compiled_Script(const Command_Tree_Index& index)
+	: mIndex(index)
+{
+	//
+}
+
+bool Compiled_Script::Open(const std::string& path, std::ostream& errOutput)
+{
+	Compiled_Script_Header hdr;
+	Compiled_Record_Header recHdr;
+	uint32_t ref;
+
+	mRecordOffsets.clear();
+
+	if (!mFile.Open(path)) {
+		errOutput << "Could not open compiled script: " << path << std::endl;
+		return false;
+	}
+
+	const uint8_t* data = mFile.Get_Data();
+	const size_t size = mFile.Get_Size();
+
+	if (size < sizeof(hdr)) {
+		errOutput << "Compiled script too short" << std::endl;
+		return false;
+	}
+
+	memcpy(&hdr, data, sizeof(hdr));
+
+	if (memcmp(hdr.magic, Compiled_Script_Magic, sizeof(hdr.magic)) != 0 || hdr.formatVersion != Script_Compiler::Format_Version) {
+		errOutput << "Not a compiled script or unsupported format version" << std::endl;
+		return false;
+	}
+	if (hdr.coreApiVersion != KETCUBE_MODULEID_CORE_API) {
+		errOutput << "Compiled script core API version mismatch (script: " << hdr.coreApiVersion << ", local: " << KETCUBE_MODULEID_CORE_API << ")" << std::endl;
+		return false;
+	}
+	if (hdr.treeFingerprint != mIndex.Get_Fingerprint()) {
+		errOutput << "Compiled script was built with different command tree" << std::endl;
+		return false;
+	}
+	if (hdr.dataSize != size - sizeof(hdr)) {
+		errOutput << "Compiled script size mismatch" << std::endl;
+		return false;
+	}
+
+	// validate all records before anything gets sent
+	size_t offset = sizeof(hdr);
+
+	for (uint32_t i = 0; i < hdr.recordCount; i++) {
+
+		if (offset + sizeof(recHdr) > size) {
+			errOutput << "Record " << i << " out of file bounds" << std::endl;
+			return false;
+		}
+
+		memcpy(&recHdr, data + offset, sizeof(recHdr));
+
+		const size_t payloadSize = sizeof(recHdr) + recHdr.refCount * sizeof(uint32_t) + recHdr.packetLen;
+
+		if (recHdr.recordSize < payloadSize || offset + recHdr.recordSize > size) {
+			errOutput << "Record " << i << " (line " << recHdr.sourceLine << ") has invalid size" << std::endl;
+			return false;
+		}
+		if (recHdr.packetLen < sizeof(ketCube_remoteTerminal_packet_header_t) || recHdr.refCount == 0) {
+			errOutput << "Record " << i << " (line " << recHdr.sourceLine << ") has invalid contents" << std::endl;
+			return false;
+		}
+
+		for (size_t r = 0; r < recHdr.refCount; r++) {
+			memcpy(&ref, data + offset + sizeof(recHdr) + r * sizeof(uint32_t), sizeof(ref));
+
+			if (mIndex.Get_Entry(ref) == nullptr) {
+				errOutput << "Record " << i << " (line " << recHdr.sourceLine << ") references unknown command" << std::endl;
+				return false;
+			}
+		}
+
+		mRecordOffsets.push_back(offset);
+		offset += recHdr.recordSize;
+	}
+
+	if (offset != size) {
+		errOutput << "Compiled script contains trailing data" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+size_t Compiled_Script::Get_Record_Count() const
+{
+	return mRecordOffsets.size();
+}
+
+void Compiled_Script::Get_Record(size_t pos, Compiled_Record& target) const
+{
+	Compiled_Record_Header recHdr;
+	uint32_t ref;
+
+	const uint8_t* rec = mFile.Get_Data() + mRecordOffsets[pos];
+
+	memcpy(&recHdr, rec, sizeof(recHdr));
+
+	target.flags = recHdr.flags;
+	target.sourceLine = recHdr.sourceLine;
+	target.packetLen = recHdr.packetLen;
+	target.packet = rec + sizeof(recHdr) + recHdr.refCount * sizeof(uint32_t);
+
+	target.commands.clear();
+	for (size_t r = 0; r < recHdr.refCount; r++) {
+		memcpy(&ref, rec + sizeof(recHdr) + r * sizeof(uint32_t), sizeof(ref));
+		target.commands.push_back(mIndex.Get_Entry(ref));
+	}
+}
@@ -0,0 +1,148 @@
+/**
+ * @file    script_compiler.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains offline script compiler and compiled script reader
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "terminal.h"
+#include "command_tree_index.h"
+#include "mapped_file.h"
+#include "line_reader.h"
+
+/*
+ * Compiled script file header; all values are stored in host byte order
+ */
+struct Compiled_Script_Header
+{
+	char magic[4];						// always "KRTC"
+	uint16_t formatVersion;				// version of this file format
+	uint16_t coreApiVersion;			// core API version the packets were encoded for
+	uint32_t treeFingerprint;			// fingerprint of command tree used for command references
+	uint32_t recordCount;				// number of packet records
+	uint32_t dataSize;					// size of all records following the header
+};
+
+/*
+ * Compiled packet record header; followed by command references (uint32_t each), packet bytes and padding to 4 bytes
+ */
+struct Compiled_Record_Header
+{
+	uint16_t recordSize;				// size of the whole record including this header and padding
+	uint8_t packetLen;					// serialized packet length
+	uint8_t refCount;					// number of command references (pending commands)
+	uint8_t flags;						// Compiled_Record_Flags
+	uint8_t reserved[3];				// reserved, zero
+	uint32_t sourceLine;				// script line of the first command in packet
+};
+
+/*
+ * Compiled packet record flags
+ */
+enum Compiled_Record_Flags : uint8_t
+{
+	Compiled_Record_No_Response = 0x01,	// node does not respond to this packet (e.g. reload)
+};
+
+/*
+ * Decoded compiled record; points directly into mapped file
+ */
+struct Compiled_Record
+{
+	const uint8_t* packet;				// serialized packet with zero sequence number
+	size_t packetLen;					// serialized packet length
+	uint8_t flags;						// Compiled_Record_Flags
+	uint32_t sourceLine;				// script line of the first command in packet
+	std::vector<ketCube_terminal_cmd_t*> commands;	// resolved pending commands
+};
+
+/*
+ * Offline script compiler; encodes the whole script into a binary packet file
+ */
+class Script_Compiler
+{
+	private:
+		// terminal used for command encoding
+		const Terminal_Base& mTerminal;
+		// command tree index for command references
+		const Command_Tree_Index& mIndex;
+		// maximum number of commands in batch
+		size_t mMaxBatchCommands;
+
+	public:
+		// current compiled file format version
+		static constexpr uint16_t Format_Version = 1;
+
+		Script_Compiler(const Terminal_Base& terminal, const Command_Tree_Index& index, long maxBatchCmds = 3);
+
+		// compiles script from input to output file using given number of threads (0 = all cores); returns false on any error
+		bool Compile(Line_Reader& input, const std::string& outputPath, std::ostream& errOutput, size_t threadCount = 0) const;
+};
+
+/*
+ * Memory-mapped compiled script
+ */
+class Compiled_Script
+{
+	private:
+		// mapped file
+		Mapped_File mFile;
+		// command tree index for resolving command references
+		const Command_Tree_Index& mIndex;
+		// offsets of all records within mapped file
+		std::vector<size_t> mRecordOffsets;
+
+	public:
+		Compiled_Script(const Command_Tree_Index& index);
+
+		// maps and validates the whole file; returns false if the file is not valid for this build
+		bool Open(const std::string& path, std::ostream& errOutput);
+
+		// retrieves number of records
+		size_t Get_Record_Count() const;
+		// retrieves record on given position
+		void Get_Record(size_t pos, Compiled_Record& target) const;
+};
@@ -0,0 +1,127 @@
+/**
+ * @file    spsc_queue.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains lock-free single-producer single-consumer queue
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread
+ */
+template<typename T>
+class Spsc_Queue final
+{
+	private:
+		// assumed cache line size; indices are kept on separate lines, so producer and consumer do not contend
+		static constexpr size_t Cache_Line_Size = 64;
+
+		// ring slots; count is power of two
+		std::vector<T> mSlots;
+		// slot count - 1
+		size_t mMask;
+
+		// position of next item to be popped; written only by consumer
+		std::atomic<size_t> mHead;
+		char mHeadPadding[Cache_Line_Size - sizeof(std::atomic<size_t>)];
+		// position of next item to be pushed; written only by producer
+		std::atomic<size_t> mTail;
+		char mTailPadding[Cache_Line_Size - sizeof(std::atomic<size_t>)];
+
+		static size_t Round_Capacity(size_t capacity)
+		{
+			size_t rounded = 1;
+			while (rounded < capacity) {
+				rounded <<= 1;
+			}
+			return rounded;
+		}
+
+	public:
+		explicit Spsc_Queue(size_t capacity)
+			: mSlots(Round_Capacity(capacity)), mMask(Round_Capacity(capacity) - 1), mHead(0), mTail(0)
+		{
+			//
+		}
+
+		Spsc_Queue(const Spsc_Queue&) = delete;
+		Spsc_Queue& operator=(const Spsc_Queue&) = delete;
+
+		// moves item to queue; producer only; returns false if the queue is full
+		bool Try_Push(T&& item)
+		{
+			const size_t tail = mTail.load(std::memory_order_relaxed);
+
+			if (tail - mHead.load(std::memory_order_acquire) > mMask) {
+				return false;
+			}
+
+			mSlots[tail & mMask] = std::move(item);
+			mTail.store(tail + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// moves oldest item out of queue; consumer only; returns false if the queue is empty
+		bool Try_Pop(T& item)
+		{
+			const size_t head = mHead.load(std::memory_order_relaxed);
+
+			if (head == mTail.load(std::memory_order_acquire)) {
+				return false;
+			}
+
+			item = std::move(mSlots[head & mMask]);
+			mHead.store(head + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// is the queue empty? exact only when called by producer or consumer
+		bool Empty() const
+		{
+			return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+		}
+};
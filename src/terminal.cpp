@@ -43,12 +43,14 @@
  */
 
 #include "terminal.h"
+#include "trace_recorder.h"
 
 #include <iostream>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <numeric>
+#include <algorithm>
 
 /*
  * Enumerator of lookup phases;
@@ -60,20 +62,9 @@ enum class LookupPhase
 	Subtree		// module or subtree follows (module NYI)
 };
 
-extern ketCube_terminal_paramSet_t commandIOParams;
-
 ketCube_moduleID_t lookup_module_id(const std::string& moduleName)
 {
-	const size_t moduleCnt = get_module_count();
-	const ketCube_cfg_Module_t* modlist = get_module_list();
-
-	for (size_t i = 0; i < moduleCnt; i++) {
-		if (moduleName == modlist[i].name) {
-			return modlist[i].id;
-		}
-	}
-
-	return KETCUBE_MODULEID_INVALID;
+	return Command_Schema::Built_In().Lookup_Module_Id(moduleName);
 }
 
 static uint8_t ketCube_terminal_getNextParam(const char* commandBuffer, uint8_t ptr)
@@ -99,8 +90,8 @@ static uint8_t ketCube_terminal_getNextParam(const char* commandBuffer, uint8_t
 	return ptr;
 }
 
-static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
-	ketCube_terminal_command_flags_t *contextFlags, const char* commandBuffer)
+static bool ketCube_terminal_parseParams(const Command_Schema& schema, ketCube_terminal_cmd_t* command,
+	ketCube_terminal_command_flags_t *contextFlags, const char* commandBuffer, ketCube_terminal_paramSet_t* params)
 {
 	uint8_t ptr = 0;
 	uint8_t len = 0;
@@ -121,12 +112,12 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 			return TRUE;
 		case KETCUBE_TERMINAL_PARAMS_STRING:
 		{
-			strncpy(commandIOParams.as_string, &(commandBuffer[commandParamsPos]), KETCUBE_TERMINAL_PARAM_STR_MAX_LENGTH);
+			strncpy(params->as_string, &(commandBuffer[commandParamsPos]), KETCUBE_TERMINAL_PARAM_STR_MAX_LENGTH);
 			return TRUE;
 		}
 		case KETCUBE_TERMINAL_PARAMS_BYTE:
 		{
-			commandIOParams.as_byte = (uint8_t)strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
+			params->as_byte = (uint8_t)strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[commandParamsPos])) {
 				return FALSE;
@@ -135,35 +126,35 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 		}
 		case KETCUBE_TERMINAL_PARAMS_BOOLEAN:
 		{
-			commandIOParams.as_uint32 = strtoul(&(commandBuffer[commandParamsPos]), &endptr, 10);
+			params->as_uint32 = strtoul(&(commandBuffer[commandParamsPos]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[commandParamsPos])) {
 				return FALSE;
 			}
 
-			if (commandIOParams.as_uint32 != 0) {
-				commandIOParams.as_bool = TRUE;
+			if (params->as_uint32 != 0) {
+				params->as_bool = TRUE;
 			}
 			else {
-				commandIOParams.as_bool = FALSE;
+				params->as_bool = FALSE;
 			}
 			return TRUE;
 		}
 		case KETCUBE_TERMINAL_PARAMS_MODULEID:
 		{
-			commandIOParams.as_module_id.module_id = (uint16_t)-1;
-			commandIOParams.as_module_id.severity = KETCUBE_CORECFG_DEFAULT_SEVERITY;
+			params->as_module_id.module_id = (uint16_t)-1;
+			params->as_module_id.severity = KETCUBE_CORECFG_DEFAULT_SEVERITY;
 
-			ketCube_cfg_Module_t *modlist = get_module_list();
-			size_t modcnt = get_module_count();
+			const std::vector<Schema_Module>& modlist = schema.modules;
+			int modcnt = (int)modlist.size();
 
-			for (i = KETCUBE_LISTS_MODULEID_FIRST; i < modcnt; i++) {
+			for (i = 0; i < modcnt; i++) {
 
-				tmpCmdLen = (int)strlen(&(modlist[i].name[0]));
+				tmpCmdLen = (int)strlen(modlist[i].name);
 
-				if (strncmp(&(modlist[i].name[0]), &(commandBuffer[commandParamsPos]), tmpCmdLen) == 0) {
+				if (strncmp(modlist[i].name, &(commandBuffer[commandParamsPos]), tmpCmdLen) == 0) {
 
-					commandIOParams.as_module_id.module_id = modlist[i].id;
+					params->as_module_id.module_id = modlist[i].id;
 
 					if (commandBuffer[commandParamsPos + tmpCmdLen] == 0x00) {
 						break;
@@ -172,9 +163,9 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 					if (commandBuffer[commandParamsPos + tmpCmdLen] == ' ') {
 
 						sscanf(&(commandBuffer[commandParamsPos + tmpCmdLen + 1]), "%d", (int*)&tmpSeverity);
-						commandIOParams.as_module_id.severity = (ketCube_severity_t)tmpSeverity;
-						if (commandIOParams.as_module_id.severity > KETCUBE_CFG_SEVERITY_DEBUG) {
-							commandIOParams.as_module_id.severity = KETCUBE_CORECFG_DEFAULT_SEVERITY;
+						params->as_module_id.severity = (ketCube_severity_t)tmpSeverity;
+						if (params->as_module_id.severity > KETCUBE_CFG_SEVERITY_DEBUG) {
+							params->as_module_id.severity = KETCUBE_CORECFG_DEFAULT_SEVERITY;
 						}
 						break;
 					}
@@ -189,7 +180,7 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 		}
 		case KETCUBE_TERMINAL_PARAMS_INT32:
 		{
-			commandIOParams.as_int32 = strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
+			params->as_int32 = strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[commandParamsPos])) {
 				return FALSE;
@@ -198,7 +189,7 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 		}
 		case KETCUBE_TERMINAL_PARAMS_UINT32:
 		{
-			commandIOParams.as_uint32 = strtoul(&(commandBuffer[commandParamsPos]), &endptr, 10);
+			params->as_uint32 = strtoul(&(commandBuffer[commandParamsPos]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[commandParamsPos])) {
 				return FALSE;
@@ -207,7 +198,7 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 		}
 		case KETCUBE_TERMINAL_PARAMS_INT32_PAIR:
 		{
-			commandIOParams.as_int32_pair.first = strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
+			params->as_int32_pair.first = strtol(&(commandBuffer[commandParamsPos]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[commandParamsPos])) {
 				return FALSE;
@@ -218,7 +209,7 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 				return FALSE;
 			}
 
-			commandIOParams.as_int32_pair.second = strtol(&(commandBuffer[ptr]), &endptr, 10);
+			params->as_int32_pair.second = strtol(&(commandBuffer[ptr]), &endptr, 10);
 
 			if (endptr == &(commandBuffer[ptr])) {
 				return FALSE;
@@ -233,9 +224,9 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 				return FALSE;
 			}
 
-			ketCube_common_Hex2Bytes((uint8_t *) &(commandIOParams.as_byte_array.data[0]), &(commandBuffer[commandParamsPos]), len);
+			ketCube_common_Hex2Bytes((uint8_t *) &(params->as_byte_array.data[0]), &(commandBuffer[commandParamsPos]), len);
 
-			commandIOParams.as_byte_array.length = len / 2;
+			params->as_byte_array.length = len / 2;
 
 			return TRUE;
 		}
@@ -244,90 +235,6 @@ static bool ketCube_terminal_parseParams(ketCube_terminal_cmd_t* command,
 	return FALSE;
 }
 
-static bool ketCube_terminal_parseCommandOutput(ketCube_terminal_cmd_t* command, std::string& out)
-{
-	uint16_t i;
-
-	if (command->outputSetType == KETCUBE_TERMINAL_PARAMS_NONE) {
-		return false;
-	}
-
-	switch (command->outputSetType)
-	{
-		case KETCUBE_TERMINAL_PARAMS_BOOLEAN:
-		{
-			if (commandIOParams.as_bool == TRUE) {
-				out = "TRUE";
-			} else {
-				out = "FALSE";
-			}
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_STRING:
-		{
-			out = commandIOParams.as_string;
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_INT32:
-		{
-			out = std::to_string(commandIOParams.as_int32);
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_UINT32:
-		{
-			out = std::to_string(commandIOParams.as_uint32);
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_BYTE:
-		{
-			out = std::to_string(static_cast<int>(commandIOParams.as_byte));
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_INT32_PAIR:
-		{
-			out = std::to_string(commandIOParams.as_int32_pair.first) + ", " + std::to_string(commandIOParams.as_int32_pair.second);
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_BYTE_ARRAY:
-		{
-			std::ostringstream ostr;
-			for (i = 0; i < commandIOParams.as_byte_array.length; i++) {
-
-				ostr << std::hex << std::setw(2) << std::setfill('0') << std::uppercase << commandIOParams.as_byte_array.data[i];
-				if (i != commandIOParams.as_byte_array.length) {
-					ostr << "-";
-				}
-			}
-
-			out = ostr.str();
-			break;
-		}
-		case KETCUBE_TERMINAL_PARAMS_MODULEID:
-		{
-			ketCube_cfg_Module_t *modlist = get_module_list();
-			size_t modcnt = get_module_count();
-
-			for (i = KETCUBE_LISTS_MODULEID_FIRST; i < modcnt; i++) {
-				if (modlist[i].id == commandIOParams.as_module_id.module_id) {
-					out = modlist[i].name;
-					break;
-				}
-			}
-
-			if (i == modcnt) {
-				out = "invalid module";
-			}
-		}
-		default:
-		{
-			out = "<unknown return type>";
-			break;
-		}
-	}
-
-	return true;
-}
-
 static bool ketCube_terminal_processCommandErrors(ketCube_terminal_command_errorCode_t retCode, std::string& out)
 {
 	if (retCode == KETCUBE_TERMINAL_CMD_ERR_OK) {
@@ -389,11 +296,14 @@ void Terminal_Base::Start_Command_Batch(Terminal_Command_Buffer& target, uint8_t
 	mPendingCommandRef.clear();
 }
 
-bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Block& target)
+ketCube_terminal_cmd_t* Terminal_Base::Lookup_Command(const std::string& cmd, Terminal_Command_Block& target, size_t& paramsPos, ketCube_terminal_command_flags_t& activeFlags) const
 {
-	size_t i;
+	return Lookup_Command(Command_Schema::Built_In(), cmd, target, paramsPos, activeFlags);
+}
 
-	std::vector<size_t> path;
+ketCube_terminal_cmd_t* Terminal_Base::Lookup_Command(const Command_Schema& schema, const std::string& cmd, Terminal_Command_Block& target, size_t& paramsPos, ketCube_terminal_command_flags_t& activeFlags) const
+{
+	size_t i;
 
 	std::vector<std::string> tokens;
 	std::istringstream istr(cmd);
@@ -403,27 +313,26 @@ bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Bloc
 	}
 
 	if (tokens.size() == 0) {
-		return false;
+		return nullptr;
 	}
 
-	ketCube_terminal_cmd_t* subtree = get_cmd_tree();
+	ketCube_terminal_cmd_t* subtree = schema.root;
+	ketCube_terminal_cmd_t* found = nullptr;
 	LookupPhase lupphase = LookupPhase::Root;
 
 	ketCube_moduleID_t moduleId;
 	size_t tokSize = 0;
 
-	ketCube_terminal_command_flags_t activeFlags;
-
 	for (size_t tok = 0; tok < tokens.size(); tok++) {
 
 		tokSize += tokens[tok].length() + 1; // +1 for space
 
 		if (lupphase == LookupPhase::Module) {
 
-			moduleId = lookup_module_id(tokens[tok]);
+			moduleId = schema.Lookup_Module_Id(tokens[tok]);
 			if (moduleId == KETCUBE_MODULEID_INVALID) {
 				//std::cerr << "Module " << tokens[tok] << " not found" << std::endl;
-				return false;
+				return nullptr;
 			}
 		}
 
@@ -444,9 +353,11 @@ bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Bloc
 
 		if (subtree[i].cmd == nullptr) {
 			//std::cerr << "Reached end of command without finding requested command" << std::endl;
-			return false;
+			return nullptr;
 		}
 
+		found = &subtree[i];
+
 		if (lupphase == LookupPhase::Root) {
 			activeFlags = subtree[i].flags;
 		} else {
@@ -455,8 +366,8 @@ bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Bloc
 
 		if (lupphase == LookupPhase::Module) {
 			target.Set_Module_ID(moduleId);
-		} else {
-			target.push_back(static_cast<uint8_t>(i));
+		} else if (!target.push_back(static_cast<uint8_t>(i))) {
+			return nullptr;
 		}
 
 		if (!subtree[i].flags.isGroup) {
@@ -477,59 +388,340 @@ bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Bloc
 		subtree = subtree[i].settingsPtr.subCmdList;
 	}
 
-	if (!subtree[i].flags.isRemote)  {
+	// input ended while still in group - incomplete command
+	if (found == nullptr || found->flags.isGroup) {
+		return nullptr;
+	}
+
+	// parameters start after the last consumed token (if any)
+	paramsPos = std::min(tokSize, cmd.length());
+
+	return found;
+}
+
+// resolves commands of a single serialized command block (module ID followed by tree path)
+static ketCube_terminal_cmd_t* Resolve_Command_Block(const Command_Schema& schema, const uint8_t* block, size_t len, bool is16bModuleId)
+{
+	size_t i, count;
+	const size_t modIdLen = is16bModuleId ? sizeof(uint16_t) : sizeof(uint8_t);
+
+	if (len < modIdLen) {
+		return nullptr;
+	}
+
+	ketCube_moduleID_t moduleId = block[0];
+	if (is16bModuleId) {
+		moduleId |= static_cast<ketCube_moduleID_t>(block[1]) << 8;
+	}
+
+	ketCube_terminal_cmd_t* subtree = schema.root;
+	LookupPhase lupphase = LookupPhase::Root;
+	size_t pos = modIdLen;
+
+	while (true) {
+
+		for (count = 0; subtree[count].cmd != nullptr; count++)
+			;
+
+		// module level is addressed by module ID from subheader, the rest by path indices
+		if (lupphase == LookupPhase::Module) {
+			for (i = 0; i < count && subtree[i].moduleId != moduleId; i++)
+				;
+		} else {
+			if (pos >= len) {
+				return nullptr;
+			}
+			i = block[pos++];
+		}
+
+		if (i >= count) {
+			return nullptr;
+		}
+
+		if (!subtree[i].flags.isGroup) {
+			return &subtree[i];
+		}
+
+		if (lupphase == LookupPhase::Root) {
+			const ketCube_terminal_command_flags_t& flags = subtree[i].flags;
+
+			if (flags.isGeneric && flags.isGroup && (flags.isSetCmd || flags.isShowCmd)) {
+				lupphase = LookupPhase::Module;
+			} else {
+				lupphase = LookupPhase::Subtree;
+			}
+		} else if (lupphase == LookupPhase::Module) {
+			lupphase = LookupPhase::Subtree;
+		}
+
+		subtree = subtree[i].settingsPtr.subCmdList;
+	}
+}
+
+bool Terminal_Base::Decode_Request_Commands(const std::vector<uint8_t>& request, std::vector<ketCube_terminal_cmd_t*>& commands) const
+{
+	ketCube_remoteTerminal_packet_header_t header;
+	ketCube_terminal_cmd_t* command;
+
+	commands.clear();
+
+	if (request.size() < sizeof(header)) {
+		return false;
+	}
+
+	memcpy(&header, request.data(), sizeof(header));
+
+	size_t pos = sizeof(header);
+
+	if (header.opcode == KETCUBE_TERMINAL_OPCODE_CMD) {
+		command = Resolve_Command_Block(Command_Schema::Built_In(), request.data() + pos, request.size() - pos, header.is_16b_moduleid);
+		if (command == nullptr) {
+			return false;
+		}
+		commands.push_back(command);
+	} else if (header.opcode == KETCUBE_TERMINAL_OPCODE_BATCH) {
+		// every block is prepended by its length
+		while (pos < request.size()) {
+			const size_t len = request[pos++];
+
+			if (pos + len > request.size()) {
+				return false;
+			}
+
+			command = Resolve_Command_Block(Command_Schema::Built_In(), request.data() + pos, len, header.is_16b_moduleid);
+			if (command == nullptr) {
+				return false;
+			}
+			commands.push_back(command);
+
+			pos += len;
+		}
+	} else {
+		return false;
+	}
+
+	return !commands.empty();
+}
+
+bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Block& target, ketCube_terminal_cmd_t*& command) const
+{
+	return Encode_Command(Command_Schema::Built_In(), cmd, target, command);
+}
+
+bool Terminal_Base::Encode_Command(const Command_Schema& schema, const std::string& cmd, Terminal_Command_Block& target, ketCube_terminal_cmd_t*& command) const
+{
+	Trace_Span span("Encode_Command");
+
+	size_t paramsPos;
+	ketCube_terminal_command_flags_t activeFlags;
+	ketCube_terminal_paramSet_t params;
+
+	// unused parameter bytes are zeroed, so the same command always encodes the same way
+	memset(&params, 0, sizeof(params));
+
+	command = Lookup_Command(schema, cmd, target, paramsPos, activeFlags);
+	if (command == nullptr) {
+		return false;
+	}
+
+	if (!command->flags.isRemote)  {
 		//std::cerr << "Attempt to execute local-only command" << std::endl;
 		return false;
 	}
 
-	uint8_t result = ketCube_terminal_parseParams(&subtree[i], &activeFlags, cmd.c_str() + tokSize);
+	uint8_t result = ketCube_terminal_parseParams(schema, command, &activeFlags, cmd.c_str() + paramsPos, &params);
 
 	if (result == FALSE) {
 		//std::cerr << "Unable to parse command parameters" << std::endl;
 		return false;
 	}
 
-	size_t paramRawLen = ketCube_terminal_GetIOParamsLength(subtree[i].paramSetType);
+	size_t paramRawLen = ketCube_terminal_GetIOParamsLength(command->paramSetType);
 	if (paramRawLen > 0) {
 		size_t origSize = target.size();
-		target.resize(origSize + paramRawLen);
+		if (!target.resize(origSize + paramRawLen)) {
+			return false;
+		}
+
+		memcpy(target.data() + origSize, &params, paramRawLen);
+	}
+
+	return true;
+}
+
+bool Terminal_Base::Encode_Command(const std::string& cmd, Terminal_Command_Block& target)
+{
+	ketCube_terminal_cmd_t* command;
+
+	if (!Encode_Command(cmd, target, command)) {
+		return false;
+	}
+
+	mPendingCommandRef.push_back(command);
+
+	return true;
+}
+
+bool Terminal_Base::Encode_Request(const Command_Schema& schema, ketCube_terminal_command_opcode_t opcode, const std::vector<std::string>& sources,
+	std::vector<uint8_t>& packet, std::vector<ketCube_terminal_cmd_t*>& commands) const
+{
+	Terminal_Command_Buffer cmdBuf;
+	ketCube_terminal_cmd_t* command;
+
+	cmdBuf.Set_Opcode(opcode);
+	cmdBuf.Set_Flag_16bit_Module_ID(false);
+	cmdBuf.Set_Sequence_No(0);
+	cmdBuf.Set_Core_Api_Version(schema.coreApiVersion);
+
+	commands.clear();
+
+	for (const std::string& source : sources) {
+		Terminal_Command_Block cmdBlock;
+
+		if (!Encode_Command(schema, source, cmdBlock, command)) {
+			return false;
+		}
+
+		cmdBuf.Set_Flag_16bit_Module_ID(cmdBuf.Has_Flag_16bit_Module_Id() || (cmdBlock.Get_Module_ID() > 0xFF));
+		if (!cmdBuf.Append(cmdBlock)) {
+			return false;
+		}
+		commands.push_back(command);
+	}
+
+	packet.clear();
+	cmdBuf.Serialize(packet);
+
+	return true;
+}
+
+bool Terminal_Base::Is_Core_Api_Mismatch(const std::vector<uint8_t>& response, uint16_t& remoteVersion)
+{
+	remoteVersion = 0;
+
+	if (response.size() <= Response_Header_Length) {
+		return false;
+	}
+
+	size_t pos = Response_Header_Length;
+	size_t len = response.size() - pos;
 
-		memcpy(target.data() + origSize, &commandIOParams, paramRawLen);
+	// the first response of batch is enough, all of them fail the same way
+	if ((response[0] & 0x0F) == KETCUBE_TERMINAL_OPCODE_BATCH) {
+		len = response[pos++];
+		if (len == 0 || pos + len > response.size()) {
+			return false;
+		}
 	}
 
-	mPendingCommandRef.push_back(&subtree[i]);
+	if (response[pos] != KETCUBE_TERMINAL_CMD_ERR_CORE_API_MISMATCH) {
+		return false;
+	}
+
+	// firmware may append its own version to the error code
+	if (len >= 3) {
+		remoteVersion = static_cast<uint16_t>(response[pos + 1] | (response[pos + 2] << 8));
+	}
 
 	return true;
 }
 
-bool Terminal_Base::Decode_Response_Contents(const std::vector<uint8_t>& response, size_t startPos, size_t length, bool& responseOK, std::string& target, ketCube_terminal_cmd_t* command) const
+void Terminal_Base::Set_Pending_Commands(const std::vector<ketCube_terminal_cmd_t*>& commands)
+{
+	mPendingCommandRef = commands;
+}
+
+const std::vector<ketCube_terminal_cmd_t*>& Terminal_Base::Get_Pending_Commands() const
+{
+	return mPendingCommandRef;
+}
+
+size_t Terminal_Base::Get_Expected_Response_Size(ketCube_terminal_command_opcode_t opcode, const std::vector<ketCube_terminal_cmd_t*>& commands) const
+{
+	size_t size = Response_Header_Length;
+
+	for (ketCube_terminal_cmd_t* command : commands) {
+		// every batch response is prepended by its length
+		if (opcode == KETCUBE_TERMINAL_OPCODE_BATCH) {
+			size++;
+		}
+
+		// error code followed by output value set
+		size++;
+		if (command->outputSetType != KETCUBE_TERMINAL_PARAMS_NONE) {
+			size += ketCube_terminal_GetIOParamsLength(command->outputSetType);
+		}
+	}
+
+	return size;
+}
+
+bool Terminal_Base::Get_Setting_Key(const std::string& cmd, std::string& key, std::vector<uint8_t>& value) const
+{
+	size_t paramsPos;
+	ketCube_terminal_command_flags_t activeFlags;
+	Terminal_Command_Block scratch, encoded;
+
+	ketCube_terminal_cmd_t* command = Lookup_Command(cmd, scratch, paramsPos, activeFlags);
+
+	// only remote commands, that change something, could be a setting
+	if (command == nullptr || !command->flags.isRemote || activeFlags.isShowCmd || command->paramSetType == KETCUBE_TERMINAL_PARAMS_NONE) {
+		return false;
+	}
+
+	if (!Encode_Command(cmd, encoded, command)) {
+		return false;
+	}
+
+	// encoded command is the command path followed by raw parameters
+	const size_t paramLen = ketCube_terminal_GetIOParamsLength(command->paramSetType);
+	if (encoded.size() < paramLen) {
+		return false;
+	}
+
+	const size_t pathLen = encoded.size() - paramLen;
+	std::ostringstream keyBuilder;
+
+	if (command->paramSetType == KETCUBE_TERMINAL_PARAMS_MODULEID) {
+		ketCube_terminal_paramSet_t params;
+		memset(&params, 0, sizeof(params));
+		memcpy(&params, encoded.data() + pathLen, std::min(paramLen, sizeof(params)));
+
+		// enable/disable-like commands share a single setting per module, the command itself is the value
+		keyBuilder << "module " << params.as_module_id.module_id;
+		value.assign(encoded.data(), encoded.data() + encoded.size());
+	} else {
+		keyBuilder << "command " << encoded.Get_Module_ID();
+		for (size_t i = 0; i < pathLen; i++) {
+			keyBuilder << ' ' << static_cast<int>(encoded.data()[i]);
+		}
+		value.assign(encoded.data() + pathLen, encoded.data() + encoded.size());
+	}
+
+	key = keyBuilder.str();
+
+	return true;
+}
+
+bool Terminal_Base::Decode_Response_Contents(const Command_Response_View& response, bool& responseOK, std::string& target, const ketCube_terminal_cmd_t* command, const Command_Schema& schema) const
 {
 	std::ostringstream resultBuilder;
-	std::string resultStr;
-	bool result, success;
+	std::string resultStr, valueError;
+	bool success;
 
 	success = true;
 
-	ketCube_terminal_command_errorCode_t errCode = static_cast<ketCube_terminal_command_errorCode_t>(response[startPos]);
-
-	result = ketCube_terminal_processCommandErrors(errCode, resultStr);
-	if (result) {
+	if (ketCube_terminal_processCommandErrors(response.errorCode, resultStr)) {
 
 		responseOK = true;
 
 		resultBuilder << resultStr;
 
-		if (length - 1 >= sizeof(commandIOParams)) {
-			resultBuilder << "Invalid value set retrieved (size = " << (length - 1) << ", expected max. size = " << sizeof(commandIOParams);
-
+		if (Response_Parser::Format_Value(response, command, schema, resultStr, valueError)) {
+			resultBuilder << std::endl << command->cmd << " returned: " << resultStr;
+		} else if (!valueError.empty()) {
+			resultBuilder << std::endl << valueError;
 			success = false;
-		} else {
-			memcpy(&commandIOParams, response.data() + startPos + 1, length - 1);
-
-			result = ketCube_terminal_parseCommandOutput(command, resultStr);
-			if (result) {
-				resultBuilder << std::endl << command->cmd << " returned: " << resultStr;
-			}
 		}
 	} else {
 		// error - no more outputs
@@ -543,6 +735,13 @@ bool Terminal_Base::Decode_Response_Contents(const std::vector<uint8_t>& respons
 
 bool Terminal_Base::Decode_Single_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const
 {
+	return Decode_Single_Response(response, mPendingCommandRef, Command_Schema::Built_In(), responseOK, target, seq, seqOK);
+}
+
+bool Terminal_Base::Decode_Single_Response(const std::vector<uint8_t>& response, const std::vector<ketCube_terminal_cmd_t*>& commands, const Command_Schema& schema, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const
+{
+	Trace_Span span("Decode_Single_Response");
+
 	bool success;
 
 	std::ostringstream resultBuilder;
@@ -559,7 +758,7 @@ bool Terminal_Base::Decode_Single_Response(const std::vector<uint8_t>& response,
 		success = false;
 	}
 	// there always has to be a pending command, so we could decode response
-	else if (mPendingCommandRef.empty()) {
+	else if (commands.empty()) {
 		resultBuilder << "No pending command" << std::endl;
 		success = false;
 	}
@@ -575,10 +774,16 @@ bool Terminal_Base::Decode_Single_Response(const std::vector<uint8_t>& response,
 	}
 	// everything OK, decode contents
 	else {
+		Command_Response_View cmdResponse;
 		std::string cmdResContents;
-		success = Decode_Response_Contents(response, 2, response.size() - 2, responseOK, cmdResContents, mPendingCommandRef[0]);
 
-		resultBuilder << cmdResContents;
+		if (!Response_Parser::Parse_Single(response, cmdResponse, cmdResContents)) {
+			resultBuilder << cmdResContents << std::endl;
+			success = false;
+		} else {
+			success = Decode_Response_Contents(cmdResponse, responseOK, cmdResContents, commands[0], schema);
+			resultBuilder << cmdResContents;
+		}
 	}
 
 	target = resultBuilder.str();
@@ -586,8 +791,15 @@ bool Terminal_Base::Decode_Single_Response(const std::vector<uint8_t>& response,
 	return success;
 }
 
-bool Terminal_Base::Decode_Batch_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const
+bool Terminal_Base::Decode_Batch_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK, std::vector<bool>* cmdStatus) const
+{
+	return Decode_Batch_Response(response, mPendingCommandRef, Command_Schema::Built_In(), responseOK, target, seq, seqOK, cmdStatus);
+}
+
+bool Terminal_Base::Decode_Batch_Response(const std::vector<uint8_t>& response, const std::vector<ketCube_terminal_cmd_t*>& commands, const Command_Schema& schema, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK, std::vector<bool>* cmdStatus) const
 {
+	Trace_Span span("Decode_Batch_Response");
+
 	bool success;
 
 	std::ostringstream resultBuilder;
@@ -604,7 +816,7 @@ bool Terminal_Base::Decode_Batch_Response(const std::vector<uint8_t>& response,
 		success = false;
 	}
 	// there always has to be a pending command
-	else if (mPendingCommandRef.empty()) {
+	else if (commands.empty()) {
 		resultBuilder << "No pending command" << std::endl;
 		success = false;
 	}
@@ -620,50 +832,99 @@ bool Terminal_Base::Decode_Batch_Response(const std::vector<uint8_t>& response,
 	}
 	// everything ok, attempt to decode insides
 	else {
-		size_t startPos;
+		std::vector<Command_Response_View> responses;
 		std::string cmdResContents;
-		bool respOK = true;
-		size_t pendCmdPos = 0;
-		size_t len;
 
-		// start at position 2 (opcode + seq), end at last byte
-		for (startPos = 2; startPos < response.size(); ) {
+		// all lengths are validated before anything is decoded
+		if (!Response_Parser::Parse_Batch(response, commands.size(), responses, cmdResContents)) {
+			resultBuilder << cmdResContents << std::endl;
+			success = false;
+		} else {
+			success = true;
+			responseOK = true;
+
+			for (size_t pendCmdPos = 0; pendCmdPos < commands.size(); pendCmdPos++) {
+				bool respOK = false, cmdSuccess = false;
+
+				if (pendCmdPos < responses.size()) {
+					cmdSuccess = Decode_Response_Contents(responses[pendCmdPos], respOK, cmdResContents, commands[pendCmdPos], schema);
+				} else {
+					// node stopped processing the batch
+					cmdResContents = std::string("No response received for command: ") + commands[pendCmdPos]->cmd;
+					cmdSuccess = true;
+				}
+
+				// overall success is determined by and-ing all partial successes
+				success = success && cmdSuccess;
+				// overall "OK" status as well
+				responseOK = responseOK && respOK;
+
+				if (cmdStatus != nullptr) {
+					cmdStatus->push_back(cmdSuccess && respOK);
+				}
 
-			// maximum number of responses is limited to actual commands issued count
-			if (pendCmdPos >= mPendingCommandRef.size()) {
-				resultBuilder << "Received response for more than the length of pending command queue" << std::endl;
-				break;
+				resultBuilder << cmdResContents << std::endl;
 			}
-			cmdResContents.clear();
+		}
+	}
 
-			// first byte = length of response byte array
-			len = response[startPos];
+	target = resultBuilder.str();
 
-			startPos++;
+	return success;
+}
 
-			// overall success is determined by and-ing all partial successes
-			success |= Decode_Response_Contents(response, startPos, len, respOK, cmdResContents, mPendingCommandRef[pendCmdPos]);
-			// overall "OK" status as well
-			responseOK |= respOK;
+void Terminal_Base::Set_Journal(Frame_Journal* journal)
+{
+	mJournal = journal;
+}
 
-			resultBuilder << cmdResContents << std::endl;
+void Terminal_Base::Journal_Frame(Journal_Direction direction, const std::string& node, const uint8_t* frame, size_t frameLen) const
+{
+	ketCube_remoteTerminal_packet_header_t header;
 
-			// move to next response byte array and command
-			startPos += len;
-			pendCmdPos++;
-		}
+	if (mJournal == nullptr) {
+		return;
 	}
 
-	target = resultBuilder.str();
+	header.seq = 0;
+	if (frameLen >= sizeof(header)) {
+		memcpy(&header, frame, sizeof(header));
+	}
 
-	return success;
+	mJournal->Record(direction, Frame_Journal::Node_Id(node), header.seq, frame, frameLen);
+}
+
+void Terminal_Base::Enqueue_Message(const std::string& node, std::vector<uint8_t>&& frame)
+{
+	std::unique_lock<std::mutex> lck(mQueue_Mtx);
+
+	mIncoming_Queue.push({ node, std::move(frame) });
+
+	mQueue_Cv.notify_one();
+}
+
+bool Terminal_Base::Send_Command(const std::string& node, const std::vector<uint8_t>& parsed_command)
+{
+	// terminal without node addressing talks just to its default node
+	if (!node.empty()) {
+		return false;
+	}
+
+	return Send_Command(parsed_command);
 }
 
 bool Terminal_Base::Await_Message(std::vector<uint8_t>& target, const size_t timeoutMs)
+{
+	std::string node;
+
+	return Await_Message(node, target, timeoutMs);
+}
+
+bool Terminal_Base::Await_Message(std::string& node, std::vector<uint8_t>& target, const size_t timeoutMs)
 {
 	std::unique_lock<std::mutex> lck(mQueue_Mtx);
 
-	auto waitPred = [this]() { return !mIncoming_Queue.empty(); };
+	auto waitPred = [this]() { return !mIncoming_Queue.empty() || mAwait_Interrupted; };
 
 	// timeoutMs == 0 means no timeout (wait forever)
 	if (timeoutMs == 0) {
@@ -672,14 +933,26 @@ bool Terminal_Base::Await_Message(std::vector<uint8_t>& target, const size_t tim
 		mQueue_Cv.wait_for(lck, std::chrono::milliseconds(timeoutMs), waitPred);
 	}
 
+	mAwait_Interrupted = false;
+
 	// timeout, stolen wakeup or some sort of app-level interruption (cv was signalized)
 	if (mIncoming_Queue.empty()) {
 		return false;
 	}
 
 	// move queue top to avoid copying
-	target = std::move(mIncoming_Queue.front());
+	node = std::move(mIncoming_Queue.front().node);
+	target = std::move(mIncoming_Queue.front().data);
 	mIncoming_Queue.pop();
 
 	return true;
 }
+
+void Terminal_Base::Interrupt_Await()
+{
+	std::unique_lock<std::mutex> lck(mQueue_Mtx);
+
+	mAwait_Interrupted = true;
+
+	mQueue_Cv.notify_all();
+}
@@ -53,6 +53,20 @@
 
 #include "impl_bridge.h"
 #include "terminal_packet_builders.h"
+#include "frame_journal.h"
+#include "command_schema.h"
+#include "response_parser.h"
+
+/*
+ * Frame received from node
+ */
+struct Terminal_Frame
+{
+	// node the frame came from; empty for the default node of terminal
+	std::string node;
+	// raw frame contents
+	std::vector<uint8_t> data;
+};
 
 /*
  * Base class for all terminal implementations
@@ -61,20 +75,36 @@ class Terminal_Base
 {
 	protected:
 		// queue of incoming messages
-		std::queue<std::vector<uint8_t>> mIncoming_Queue;
+		std::queue<Terminal_Frame> mIncoming_Queue;
 		// mutex for queue locking
 		std::mutex mQueue_Mtx;
 		// condition variable for producer/consument-style message passing
 		std::condition_variable mQueue_Cv;
+		// was the message awaiting interrupted?
+		bool mAwait_Interrupted = false;
 
 		// vector of pending commands; one record when using single-cmd mode, multiple records in batch mode
 		std::vector<ketCube_terminal_cmd_t*> mPendingCommandRef;
 
+		// journal of all frames sent and received; nullptr if not journaling
+		Frame_Journal* mJournal = nullptr;
+
 	protected:
+		// walks the command tree along given command; fills path to target block, returns command leaf or nullptr if not found
+		ketCube_terminal_cmd_t* Lookup_Command(const std::string& cmd, Terminal_Command_Block& target, size_t& paramsPos, ketCube_terminal_command_flags_t& activeFlags) const;
+		// walks the command tree of given schema along given command
+		ketCube_terminal_cmd_t* Lookup_Command(const Command_Schema& schema, const std::string& cmd, Terminal_Command_Block& target, size_t& paramsPos, ketCube_terminal_command_flags_t& activeFlags) const;
+		// stores frame of given node to journal, if any
+		void Journal_Frame(Journal_Direction direction, const std::string& node, const uint8_t* frame, size_t frameLen) const;
+		// pushes received frame to incoming queue
+		void Enqueue_Message(const std::string& node, std::vector<uint8_t>&& frame);
 		// decodes contents of response regardless the type
-		bool Decode_Response_Contents(const std::vector<uint8_t>& response, size_t startPos, size_t length, bool& responseOK, std::string& target, ketCube_terminal_cmd_t* command) const;
+		bool Decode_Response_Contents(const Command_Response_View& response, bool& responseOK, std::string& target, const ketCube_terminal_cmd_t* command, const Command_Schema& schema) const;
 
 	public:
+		// length of response header (opcode and sequence number)
+		static constexpr size_t Response_Header_Length = 2;
+
 		Terminal_Base() = default;
 		virtual ~Terminal_Base() = default;
 
@@ -87,14 +117,45 @@ class Terminal_Base
 
 		// encodes command using command tree
 		bool Encode_Command(const std::string& cmd, Terminal_Command_Block& target);
+		// encodes command using command tree without touching pending commands (thread-safe); retrieves the command leaf
+		bool Encode_Command(const std::string& cmd, Terminal_Command_Block& target, ketCube_terminal_cmd_t*& command) const;
+		// encodes command using command tree of given schema (thread-safe); retrieves the command leaf
+		bool Encode_Command(const Command_Schema& schema, const std::string& cmd, Terminal_Command_Block& target, ketCube_terminal_cmd_t*& command) const;
+		// encodes whole request packet (with zero sequence number) from source commands using given schema (thread-safe)
+		bool Encode_Request(const Command_Schema& schema, ketCube_terminal_command_opcode_t opcode, const std::vector<std::string>& sources,
+			std::vector<uint8_t>& packet, std::vector<ketCube_terminal_cmd_t*>& commands) const;
+		// checks, if response reports core API mismatch; retrieves remote version if the firmware sent it (0 otherwise)
+		static bool Is_Core_Api_Mismatch(const std::vector<uint8_t>& response, uint16_t& remoteVersion);
+		// resolves commands contained in serialized request packet (e.g. captured downlink); returns false if not valid
+		bool Decode_Request_Commands(const std::vector<uint8_t>& request, std::vector<ketCube_terminal_cmd_t*>& commands) const;
+		// replaces pending commands, e.g. when sending pre-encoded packet
+		void Set_Pending_Commands(const std::vector<ketCube_terminal_cmd_t*>& commands);
+		// retrieves pending commands encoded since last Start_Single_Command/Start_Command_Batch
+		const std::vector<ketCube_terminal_cmd_t*>& Get_Pending_Commands() const;
+		// estimates size of response to packet with given opcode and commands
+		size_t Get_Expected_Response_Size(ketCube_terminal_command_opcode_t opcode, const std::vector<ketCube_terminal_cmd_t*>& commands) const;
+		// retrieves identifier of setting changed by given command and its encoded value; both are derived from the encoded command,
+		// so different spellings of the same setting match; returns false if the command is not a setting
+		bool Get_Setting_Key(const std::string& cmd, std::string& key, std::vector<uint8_t>& value) const;
 
 		// decodes response of single command requst
 		bool Decode_Single_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const;
-		// decodes response of batch command request
-		bool Decode_Batch_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const;
+		// decodes response of single command requst against given pending commands of node using given schema
+		bool Decode_Single_Response(const std::vector<uint8_t>& response, const std::vector<ketCube_terminal_cmd_t*>& commands, const Command_Schema& schema, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK) const;
+		// decodes response of batch command request; optionally stores OK status of every command in batch
+		bool Decode_Batch_Response(const std::vector<uint8_t>& response, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK, std::vector<bool>* cmdStatus = nullptr) const;
+		// decodes response of batch command request against given pending commands of node using given schema; optionally stores OK status of every command in batch
+		bool Decode_Batch_Response(const std::vector<uint8_t>& response, const std::vector<ketCube_terminal_cmd_t*>& commands, const Command_Schema& schema, bool& responseOK, std::string& target, uint8_t seq, bool& seqOK, std::vector<bool>* cmdStatus = nullptr) const;
+
+		// sets journal for all frames sent and received; nullptr disables journaling
+		void Set_Journal(Frame_Journal* journal);
 
-		// awaits message for given period of time; returns true on success, false on timeout
+		// awaits message for given period of time; returns true on success, false on timeout or interruption
 		bool Await_Message(std::vector<uint8_t>& target, const size_t timeoutMs);
+		// awaits message from any node for given period of time; returns true on success, false on timeout or interruption
+		bool Await_Message(std::string& node, std::vector<uint8_t>& target, const size_t timeoutMs);
+		// wakes up the thread waiting in Await_Message
+		void Interrupt_Await();
 
 		/* interface */
 
@@ -102,4 +163,6 @@ class Terminal_Base
 		virtual bool Init() { return true; };
 		// sends command to remote endpoint using given settings
 		virtual bool Send_Command(const std::vector<uint8_t>& parsed_command) = 0;
+		// sends command to given node; empty node means the default node of terminal
+		virtual bool Send_Command(const std::string& node, const std::vector<uint8_t>& parsed_command);
 };
@@ -43,114 +43,154 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <vector>
-#include <random>
+#include <cstdlib>
 #include "mqtt_terminal.h"
 
 #include "terminal_handler.h"
+#include "airtime_planner.h"
 
-// random device instance for generating initial SEQ's
-static std::random_device Random_Device;
-
-Terminal_Handler::Terminal_Handler(std::istream& input, std::ostream& output, long responseTimeoutSecs, long maxBatchCommands)
-	: mInput(input), mOutput(output), mResponseTimeout(responseTimeoutSecs * 1000), mMaxBatchCommands(static_cast<size_t>(maxBatchCommands))
+Terminal_Handler::Terminal_Handler(Command_Dispatcher& dispatcher, Line_Reader& input, Output_Sink& output, long maxBatchCommands)
+	: mDispatcher(dispatcher), mInput(input), mOutput(output), mMaxBatchCommands(static_cast<size_t>(maxBatchCommands)), mPlanner(nullptr)
 {
 	//
 }
 
-void Terminal_Handler::Process_Single(Terminal_Base& terminal, const Terminal_Command_Buffer& cmdBuf, std::string& inStr)
+void Terminal_Handler::Set_Planner(const Airtime_Planner* planner)
 {
-	bool result, responseOK, seqOK;
-	std::vector<uint8_t> encoded, response;
-	std::string respStr;
+	mPlanner = planner;
+}
 
-	cmdBuf.Serialize(encoded);
+void Terminal_Handler::Print(const std::string& line)
+{
+	mOutput.Write_Line(line);
+}
 
-	result = terminal.Send_Command(encoded);
-	if (!result) {
-		mOutput << "Send_Command: failed to send command: " << inStr << std::endl;
-		return;
+void Terminal_Handler::Print_Result(const Command_Result& result, bool withTicket)
+{
+	std::string prefix;
+	if (withTicket) {
+		prefix = "[#" + std::to_string(result.ticket) + "] ";
 	}
 
-	// when sending "reload", we actually have no chance to send back response
-	if (inStr == "reload") {
-		mOutput << "(node will be reloaded on next period timer tick; no response expected)" << std::endl;
-		return;
+	// single record, so the lines of one result are never interleaved with other output
+	std::string record;
+
+	if (result.retransmissions > 0) {
+		record += prefix + "(command retransmitted " + std::to_string(result.retransmissions) + " times)\n";
 	}
 
-	do {
-		response.clear();
+	record += prefix + result.output + "\n";
 
-		result = terminal.Await_Message(response, mResponseTimeout);
-		if (!result) {
-			mOutput << "Await_Message: no response received" << std::endl;
-			break;
-		}
+	mOutput.Write(std::move(record));
+}
 
-		result = terminal.Decode_Single_Response(response, responseOK, respStr, cmdBuf.Get_Sequence_No(), seqOK);
-	} while (!seqOK);
+Command_Request Terminal_Handler::Make_Request(const Terminal_Command_Buffer& cmdBuf, const std::vector<ketCube_terminal_cmd_t*>& commands,
+	const std::vector<std::string>& sources, const std::string& description, Command_Priority priority, bool expectResponse) const
+{
+	Command_Request request;
 
-	if (!result) {
-		mOutput << "Decode_Response: failed to decode incoming byte buffer" << std::endl;
-		return;
-	}
+	cmdBuf.Serialize(request.packet);
+	request.commands = commands;
+	request.sources = sources;
+	request.expectResponse = expectResponse;
+	request.description = description;
+	request.priority = priority;
 
-	std::cout << respStr << std::endl;
+	return request;
 }
 
-void Terminal_Handler::Process_Batch(Terminal_Base& terminal, const Terminal_Command_Buffer& cmdBuf)
+Command_Result Terminal_Handler::Execute(Command_Request&& request)
 {
-	bool result, responseOK, seqOK;
-	std::vector<uint8_t> encoded, response;
-	std::string respStr;
+	Command_Result result;
 
-	cmdBuf.Serialize(encoded);
+	mDispatcher.Wait(mDispatcher.Submit(std::move(request)), &result);
 
-	result = terminal.Send_Command(encoded);
-	if (!result) {
-		mOutput << "Send_Command: failed to send command batch" << std::endl;
-		return;
-	}
+	return result;
+}
 
-	do {
-		response.clear();
+bool Terminal_Handler::Process_Async_Control(const std::string& inStr)
+{
+	std::istringstream ss(inStr);
+	std::string cmd, ticketStr;
 
-		result = terminal.Await_Message(response, mResponseTimeout);
-		if (!result) {
-			mOutput << "Await_Message: no response received" << std::endl;
-			return;
+	ss >> cmd >> ticketStr;
+
+	const uint64_t ticket = std::strtoull(ticketStr.c_str(), nullptr, 10);
+
+	if (cmd == "!pending") {
+		const std::vector<Pending_Command_Info> pending = mDispatcher.Get_Pending();
+
+		if (pending.empty()) {
+			Print("No pending commands");
 		}
 
-		result = terminal.Decode_Batch_Response(response, responseOK, respStr, cmdBuf.Get_Sequence_No(), seqOK);
-	} while (!seqOK);
+		for (const Pending_Command_Info& info : pending) {
+			Print("[#" + std::to_string(info.ticket) + "] " + (info.inFlight ? "in flight" : "queued") + " (" + Command_Priority_Name(info.priority) + "): " + info.description);
+		}
+	} else if (cmd == "!wait") {
+		if (ticketStr.empty()) {
+			mDispatcher.Wait_All();
+		} else if (!mDispatcher.Wait(ticket)) {
+			Print("Unknown or already completed ticket: " + ticketStr);
+		}
+	} else if (cmd == "!stats") {
+		std::ostringstream stats;
+		Duty_Cycle_Limiter::Print_Usage(mDispatcher.Get_Duty_Cycle_Usage(true), stats);
+
+		if (stats.str().empty()) {
+			stats << "No airtime consumed" << std::endl;
+		}
+
+		for (const Command_Latency& lat : mDispatcher.Get_Latency()) {
+			stats << Command_Priority_Name(lat.priority) << ": " << lat.completed << " completed, queued avg " << static_cast<long>(lat.avgQueueMs)
+				<< " ms / max " << lat.maxQueueMs << " ms, total avg " << static_cast<long>(lat.avgTotalMs) << " ms / max " << lat.maxTotalMs << " ms" << std::endl;
+		}
 
-	if (!result) {
-		mOutput << "Decode_Response: failed to decode incoming byte buffer" << std::endl;
-		return;
+		mOutput.Write(stats.str());
+	} else if (cmd == "!cancel") {
+		if (ticketStr.empty()) {
+			Print("Usage: !cancel <ticket>");
+		} else if (!mDispatcher.Cancel(ticket)) {
+			Print("Unknown or already completed ticket: " + ticketStr);
+		}
+	} else {
+		return false;
 	}
 
-	std::cout << respStr << std::endl;
+	return true;
 }
 
-int Terminal_Handler::Run(Terminal_Base& terminal)
+int Terminal_Handler::Run(bool async)
 {
-	std::vector<uint8_t> response;
+	Terminal_Base& terminal = mDispatcher.Get_Terminal();
 	Terminal_Command_Buffer cmdBuf;
+	std::vector<std::string> batchSources;
 	bool result, batchMode;
-	std::string inStr, respStr;
+	std::string inStr;
 	size_t batchCtr;
 
 	batchMode = false;
-	uint8_t seq = static_cast<uint8_t>(Random_Device());
-
 	batchCtr = 0;
 
-	auto assignSeq = [&seq]() { return ++seq; };
+	// submits request either asynchronously with ticket, or waits for its result
+	auto submit = [&](Command_Request&& request) {
+		if (!async) {
+			Print_Result(Execute(std::move(request)), false);
+			return;
+		}
+
+		const std::string description = request.description;
+		const uint64_t ticket = mDispatcher.Submit(std::move(request), [this](const Command_Result& res) { Print_Result(res, true); });
+
+		Print("[#" + std::to_string(ticket) + "] submitted: " + description);
+	};
 
-	while (mInput.good() && mOutput.good()) {
-		mOutput << ">> ";
+	while (mOutput.Good()) {
+		mOutput.Write(">> ", true);
 
-		if (std::getline(mInput, inStr)) {
+		if (mInput.Next(inStr)) {
 			if (inStr.length() == 0)
 				continue;
 
@@ -158,35 +198,36 @@ int Terminal_Handler::Run(Terminal_Base& terminal)
 
 				if (inStr == "!batch") {
 					if (batchMode) {
-						mOutput << "Batch mode already started!" << std::endl;
+						Print("Batch mode already started!");
 					} else {
 						batchCtr = 0;
 						batchMode = true;
-						mOutput << "Batch mode begin" << std::endl;
+						Print("Batch mode begin");
 
 						cmdBuf.Reset();
-						terminal.Start_Command_Batch(cmdBuf, assignSeq());
+						batchSources.clear();
+						terminal.Start_Command_Batch(cmdBuf, 0);
 					}
 				} else if (inStr == "!commit") {
 					if (!batchMode) {
-						mOutput << "Not in batch mode!" << std::endl;
+						Print("Not in batch mode!");
 					} else if (batchCtr == 0) {
-						mOutput << "No batch commands entered!" << std::endl;
+						Print("No batch commands entered!");
 					} else {
 						batchMode = false;
-						mOutput << "Batch mode ended; performing commit" << std::endl;
+						Print("Batch mode ended; performing commit");
 
-						Process_Batch(terminal, cmdBuf);
+						submit(Make_Request(cmdBuf, terminal.Get_Pending_Commands(), batchSources, "batch of " + std::to_string(batchCtr) + " commands", Command_Priority::Interactive));
 					}
 				} else if (inStr == "!abort") {
 					if (!batchMode) {
-						mOutput << "Not in batch mode!" << std::endl;
+						Print("Not in batch mode!");
 					} else	{
 						batchMode = false;
-						mOutput << "Batch mode aborted" << std::endl;
+						Print("Batch mode aborted");
 					}
-				} else {
-					mOutput << "Unknown control command: " << inStr << std::endl;
+				} else if (!async || !Process_Async_Control(inStr)) {
+					Print("Unknown control command: " + inStr);
 				}
 
 				continue;
@@ -196,33 +237,183 @@ int Terminal_Handler::Run(Terminal_Base& terminal)
 
 			if (batchMode) {
 				if (batchCtr >= mMaxBatchCommands) {
-					mOutput << "Maximum number of batch commands reached: " << batchCtr << "; please, perform !commit" << std::endl;
+					Print("Maximum number of batch commands reached: " + std::to_string(batchCtr) + "; please, perform !commit");
 					continue;
 				}
 			} else	{
 				cmdBuf.Reset();
-				terminal.Start_Single_Command(cmdBuf, assignSeq());
+				terminal.Start_Single_Command(cmdBuf, 0);
 			}
 
 			result = terminal.Encode_Command(inStr, cmdBlock);
 			if (!result) {
-				mOutput << "Encode_Command: unknown command: " << inStr << std::endl;
+				Print("Encode_Command: unknown command: " + inStr);
 				continue;
 			}
 
 			cmdBuf.Set_Flag_16bit_Module_ID(cmdBuf.Has_Flag_16bit_Module_Id() || (cmdBlock.Get_Module_ID() > 0xFF));
-			cmdBuf.Append(cmdBlock);
+			if (!cmdBuf.Append(cmdBlock)) {
+				// the command is not part of the packet, so it must not be used for response decoding
+				std::vector<ketCube_terminal_cmd_t*> pending = terminal.Get_Pending_Commands();
+				pending.pop_back();
+				terminal.Set_Pending_Commands(pending);
+
+				Print("Packet does not fit into single frame: " + inStr);
+				continue;
+			}
 
 			if (!batchMode) {
-				Process_Single(terminal, cmdBuf, inStr);
+				// when sending "reload", we actually have no chance to send back response
+				submit(Make_Request(cmdBuf, terminal.Get_Pending_Commands(), { inStr }, inStr, Command_Priority::Interactive, inStr != "reload"));
 			} else {
 				batchCtr++;
-				mOutput << "Enqueued batch command: " << inStr << std::endl;
+				batchSources.push_back(inStr);
+				Print("Enqueued batch command: " + inStr);
 			}
 		} else {
 			break;
 		}
 	}
 
+	// let the results of submitted commands arrive
+	if (async) {
+		mDispatcher.Wait_All();
+	}
+
 	return 0;
 }
+
+int Terminal_Handler::Reconcile(Config_Reconciler& reconciler)
+{
+	Terminal_Base& terminal = mDispatcher.Get_Terminal();
+	Terminal_Command_Buffer cmdBuf;
+	std::vector<std::string> batchCmds;
+	std::vector<ketCube_terminal_cmd_t*> batchRefs;
+	Airtime_Estimate total;
+	size_t failedCnt = 0;
+
+	const std::vector<std::string> diff = reconciler.Diff();
+
+	Output_Record(mOutput) << "Reconcile: " << diff.size() << " of " << reconciler.Get_Profile_Size() << " settings differ from last-known state" << '\n';
+
+	for (size_t pos = 0; pos < diff.size(); ) {
+
+		cmdBuf.Reset();
+		terminal.Start_Command_Batch(cmdBuf, 0);
+		batchCmds.clear();
+		batchRefs.clear();
+
+		// pack as many commands as the batch allows and the frame fits
+		for (; pos < diff.size() && batchCmds.size() < mMaxBatchCommands; pos++) {
+
+			Terminal_Command_Block cmdBlock;
+			ketCube_terminal_cmd_t* command;
+
+			if (!terminal.Encode_Command(diff[pos], cmdBlock, command)) {
+				Output_Record(mOutput) << "Encode_Command: unknown command: " << diff[pos] << '\n';
+				failedCnt++;
+				continue;
+			}
+
+			Terminal_Command_Buffer candidate = cmdBuf;
+			candidate.Set_Flag_16bit_Module_ID(candidate.Has_Flag_16bit_Module_Id() || (cmdBlock.Get_Module_ID() > 0xFF));
+
+			if (!candidate.Append(cmdBlock)) {
+				// the rest goes to next frame
+				if (!batchCmds.empty()) {
+					break;
+				}
+
+				Output_Record(mOutput) << "Packet does not fit into single frame: " << diff[pos] << '\n';
+				failedCnt++;
+				continue;
+			}
+
+			if (mPlanner != nullptr && !batchCmds.empty()) {
+				std::vector<ketCube_terminal_cmd_t*> candidateRefs = batchRefs;
+				candidateRefs.push_back(command);
+
+				// the rest goes to next frame
+				if (!mPlanner->Fits(candidate.Get_Serialized_Size(), terminal.Get_Expected_Response_Size(KETCUBE_TERMINAL_OPCODE_BATCH, candidateRefs))) {
+					break;
+				}
+			}
+
+			cmdBuf = std::move(candidate);
+			batchCmds.push_back(diff[pos]);
+			batchRefs.push_back(command);
+
+			Output_Record(mOutput) << "Enqueued batch command: " << diff[pos] << '\n';
+		}
+
+		if (batchCmds.empty()) {
+			continue;
+		}
+
+		Command_Request request = Make_Request(cmdBuf, batchRefs, batchCmds, "reconcile batch", Command_Priority::Bulk);
+
+		if (mPlanner != nullptr) {
+			const Airtime_Estimate estimate = mPlanner->Estimate(request);
+			total += estimate;
+
+			Output_Record(mOutput) << "Estimated airtime of batch: " << estimate.downlinkMs << " ms downlink, " << estimate.uplinkMs << " ms response" << '\n';
+		}
+
+		const Command_Result result = Execute(std::move(request));
+		Print_Result(result, false);
+
+		if (result.status != Command_Status::OK) {
+			failedCnt += batchCmds.size();
+			continue;
+		}
+
+		// commands without response status are considered not applied
+		for (size_t i = 0; i < batchCmds.size(); i++) {
+			if (i < result.cmdStatus.size() && result.cmdStatus[i]) {
+				reconciler.Learn(batchCmds[i]);
+			} else {
+				failedCnt++;
+			}
+		}
+	}
+
+	Output_Record(mOutput) << "Reconcile: " << (diff.size() - failedCnt) << " applied, " << failedCnt << " failed" << '\n';
+
+	if (mPlanner != nullptr) {
+		Output_Record(mOutput) << "Estimated airtime: " << total.frames << " frames, " << total.downlinkMs << " ms downlink, " << total.uplinkMs << " ms response" << '\n';
+	}
+
+	return (failedCnt == 0) ? 0 : 4;
+}
+
+int Terminal_Handler::Replay(const Compiled_Script& script)
+{
+	Compiled_Record record;
+	size_t failedCnt = 0;
+
+	for (size_t i = 0; i < script.Get_Record_Count() && mOutput.Good(); i++) {
+
+		script.Get_Record(i, record);
+
+		// packets are stored with zero sequence number, dispatcher assigns the real one
+		Command_Request request;
+		request.packet.assign(record.packet, record.packet + record.packetLen);
+		request.commands = record.commands;
+		request.expectResponse = !(record.flags & Compiled_Record_No_Response);
+		request.description = "line " + std::to_string(record.sourceLine);
+		request.priority = Command_Priority::Bulk;
+
+		Output_Record(mOutput) << ">> (line " << record.sourceLine << ")\n";
+
+		const Command_Result result = Execute(std::move(request));
+		Print_Result(result, false);
+
+		if (result.status != Command_Status::OK) {
+			failedCnt++;
+		}
+	}
+
+	Output_Record(mOutput) << "Replay: " << (script.Get_Record_Count() - failedCnt) << " packets processed, " << failedCnt << " failed" << '\n';
+
+	return (failedCnt == 0) ? 0 : 4;
+}
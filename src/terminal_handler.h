@@ -45,8 +45,16 @@
 #pragma once
 
 #include <iostream>
+#include <mutex>
 
 #include "terminal.h"
+#include "command_dispatcher.h"
+#include "config_reconciler.h"
+#include "script_compiler.h"
+#include "line_reader.h"
+#include "output_sink.h"
+
+class Airtime_Planner;
 
 /*
  * Terminal handler class - manages the outer logic of reading from file and performing send routines
@@ -54,25 +62,43 @@
 class Terminal_Handler final
 {
 	private:
-		// input file
-		std::istream& mInput;
-		// output file
-		std::ostream& mOutput;
+		// dispatcher of commands
+		Command_Dispatcher& mDispatcher;
+		// input lines
+		Line_Reader& mInput;
+		// output sink, written also from dispatcher thread
+		Output_Sink& mOutput;
 
-		// timeout for response to command
-		long mResponseTimeout;
 		// maximum number of commands in batch
 		size_t mMaxBatchCommands;
+		// airtime planner used for packing batches; nullptr if not used
+		const Airtime_Planner* mPlanner;
 
 	protected:
-		// processes sending of single command request
-		void Process_Single(Terminal_Base& terminal, const Terminal_Command_Buffer& cmdBuf, std::string& inStr);
-		// processes sending of batch command request
-		void Process_Batch(Terminal_Base& terminal, const Terminal_Command_Buffer& cmdBuf);
+		// writes line to output
+		void Print(const std::string& line);
+		// writes result of completed command to output
+		void Print_Result(const Command_Result& result, bool withTicket);
+
+		// builds request of given priority class from encoded command buffer, commands contained in it and their source lines
+		Command_Request Make_Request(const Terminal_Command_Buffer& cmdBuf, const std::vector<ketCube_terminal_cmd_t*>& commands,
+			const std::vector<std::string>& sources, const std::string& description, Command_Priority priority, bool expectResponse = true) const;
+		// submits request and waits for its result
+		Command_Result Execute(Command_Request&& request);
+
+		// processes control command of asynchronous mode; returns true if the command was recognized
+		bool Process_Async_Control(const std::string& inStr);
 
 	public:
-		Terminal_Handler(std::istream& input, std::ostream& output, long responseTimeoutSecs = 60, long maxBatchCmds = 3);
+		Terminal_Handler(Command_Dispatcher& dispatcher, Line_Reader& input, Output_Sink& output, long maxBatchCmds = 3);
+
+		// sets airtime planner used for packing batches to frames
+		void Set_Planner(const Airtime_Planner* planner);
 
-		// runs the terminal routine, ends after the input reports eof/invalid state
-		int Run(Terminal_Base& terminal);
+		// runs the terminal routine, ends at the end of input; in asynchronous mode, commands do not block the prompt
+		int Run(bool async = false);
+		// sends only commands needed to reach the desired profile, packed into as few frames as possible; successful commands are learned by reconciler
+		int Reconcile(Config_Reconciler& reconciler);
+		// sends all packets of pre-validated compiled script
+		int Replay(const Compiled_Script& script);
 };
@@ -43,9 +43,13 @@
  */
 
 
+#include <cstring>
+
 #include "terminal_packet_builders.h"
+#include "trace_recorder.h"
 
 Terminal_Command_Buffer::Terminal_Command_Buffer()
+	: mBlockCount(0), mContentsLength(0), mBodyLength(0)
 {
 	// always set current API version
 	mHeader.coreApiVersion = KETCUBE_MODULEID_CORE_API;
@@ -71,6 +75,16 @@ uint8_t Terminal_Command_Buffer::Get_Sequence_No() const
 	return mHeader.seq;
 }
 
+void Terminal_Command_Buffer::Set_Core_Api_Version(uint16_t version)
+{
+	mHeader.coreApiVersion = version;
+}
+
+uint16_t Terminal_Command_Buffer::Get_Core_Api_Version() const
+{
+	return mHeader.coreApiVersion;
+}
+
 void Terminal_Command_Buffer::Set_Flag_16bit_Module_ID(bool set)
 {
 	mHeader.is_16b_moduleid = set;
@@ -81,19 +95,12 @@ bool Terminal_Command_Buffer::Has_Flag_16bit_Module_Id() const
 	return mHeader.is_16b_moduleid;
 }
 
-void Terminal_Command_Buffer::Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options) const
+TSerializable_Options Terminal_Command_Buffer::Get_Block_Options() const
 {
 	TSerializable_Options opts;
 
 	opts.IsModuleID16Bit = mHeader.is_16b_moduleid;
 
-	// nasty scope; serialize header
-	{
-		const uint8_t* hdrPtr = reinterpret_cast<const uint8_t*>(&mHeader);
-		for (size_t i = 0; i < sizeof(ketCube_remoteTerminal_packet_header_t); i++)
-			bytesTarget.push_back(hdrPtr[i]);
-	}
-
 	// depending on opcode, serializer options vary
 	switch (Get_Opcode())
 	{
@@ -105,37 +112,144 @@ void Terminal_Command_Buffer::Serialize(std::vector<uint8_t>& bytesTarget, const
 			break;
 	}
 
+	return opts;
+}
+
+void Terminal_Command_Buffer::Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options) const
+{
+	const size_t origSize = bytesTarget.size();
+
+	bytesTarget.resize(origSize + Get_Serialized_Size(options));
+
+	Serialize_To(bytesTarget.data() + origSize, options);
+}
+
+size_t Terminal_Command_Buffer::Get_Serialized_Size(const TSerializable_Options& options) const
+{
+	const TSerializable_Options opts = Get_Block_Options();
+
+	// every block adds its contents, module ID and optional length
+	const size_t blockOverhead = (opts.PrependLength ? 1 : 0) + (opts.IsModuleID16Bit ? sizeof(uint16_t) : sizeof(uint8_t));
+
+	return sizeof(ketCube_remoteTerminal_packet_header_t) + mBlockCount * blockOverhead + mContentsLength;
+}
+
+uint8_t* Terminal_Command_Buffer::Serialize_To(uint8_t* target, const TSerializable_Options& options) const
+{
+	Trace_Span span("Serialize");
+
+	const TSerializable_Options opts = Get_Block_Options();
+
+	// serialize header
+	memcpy(target, &mHeader, sizeof(ketCube_remoteTerminal_packet_header_t));
+	target += sizeof(ketCube_remoteTerminal_packet_header_t);
+
 	// serialize all terminal command blocks
-	for (size_t i = 0; i < mBlocks.size(); i++) {
-		mBlocks[i].Serialize(bytesTarget, opts);
+	for (size_t pos = 0; pos < mBodyLength; ) {
+		const uint8_t length = mBody[pos];
+		const uint8_t* block = &mBody[pos + 1];
+
+		// the length includes module ID ("subheader")
+		if (opts.PrependLength) {
+			*target++ = static_cast<uint8_t>(length + (opts.IsModuleID16Bit ? sizeof(uint16_t) : sizeof(uint8_t)));
+		}
+
+		*target++ = block[0];
+		if (opts.IsModuleID16Bit) {
+			*target++ = block[1];
+		}
+
+		memcpy(target, block + 2, length);
+		target += length;
+
+		pos += 3 + length;
 	}
+
+	return target;
 }
 
-void Terminal_Command_Buffer::Append(const Terminal_Command_Block& block)
+bool Terminal_Command_Buffer::Append(const Terminal_Command_Block& block)
 {
-	mBlocks.push_back(block);
+	const size_t stored = 3 + block.size();
+
+	if (mBodyLength + stored > Body_Capacity) {
+		return false;
+	}
+
+	const uint16_t origBlockCount = mBlockCount;
+	const uint16_t origContentsLength = mContentsLength;
+
+	mBlockCount++;
+	mContentsLength += static_cast<uint16_t>(block.size());
+
+	if (Get_Serialized_Size() > Terminal_Max_Packet_Length) {
+		mBlockCount = origBlockCount;
+		mContentsLength = origContentsLength;
+		return false;
+	}
+
+	uint8_t* target = &mBody[mBodyLength];
+	target[0] = static_cast<uint8_t>(block.size());
+	target[1] = static_cast<uint8_t>(block.Get_Module_ID() & 0xFF);
+	target[2] = static_cast<uint8_t>((block.Get_Module_ID() >> 8) & 0xFF);
+	memcpy(target + 3, block.data(), block.size());
+
+	mBodyLength += static_cast<uint16_t>(stored);
+
+	return true;
+}
+
+size_t Terminal_Command_Buffer::Get_Block_Count() const
+{
+	return mBlockCount;
 }
 
 void Terminal_Command_Buffer::Reset()
 {
-	mBlocks.clear();
+	mBlockCount = 0;
+	mContentsLength = 0;
+	mBodyLength = 0;
+}
+
+Terminal_Command_Block::Terminal_Command_Block()
+	: mModuleID(0), mLength(0)
+{
+	//
 }
 
 void Terminal_Command_Block::Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options) const
+{
+	const size_t origSize = bytesTarget.size();
+
+	bytesTarget.resize(origSize + Get_Serialized_Size(options));
+
+	Serialize_To(bytesTarget.data() + origSize, options);
+}
+
+size_t Terminal_Command_Block::Get_Serialized_Size(const TSerializable_Options& options) const
+{
+	return (options.PrependLength ? 1 : 0) + (options.IsModuleID16Bit ? sizeof(uint16_t) : sizeof(uint8_t)) + size();
+}
+
+uint8_t* Terminal_Command_Block::Serialize_To(uint8_t* target, const TSerializable_Options& options) const
 {
 	// prepend length; the length includes module ID ("subheader")
 	if (options.PrependLength) {
-		bytesTarget.push_back(static_cast<uint8_t>(size() + (options.IsModuleID16Bit ? sizeof(uint16_t) : sizeof(uint8_t))));
+		*target++ = static_cast<uint8_t>(size() + (options.IsModuleID16Bit ? sizeof(uint16_t) : sizeof(uint8_t)));
 	}
 
 	// append module ID (LSB, and if 16bit flag is set, include MSB)
-	bytesTarget.push_back(static_cast<uint8_t>(mModuleID & 0xFF));
+	*target++ = static_cast<uint8_t>(mModuleID & 0xFF);
 	if (options.IsModuleID16Bit) {
-		bytesTarget.push_back(static_cast<uint8_t>((mModuleID >> 8) & 0xFF));
+		*target++ = static_cast<uint8_t>((mModuleID >> 8) & 0xFF);
 	}
 
 	// copy the rest of contents (the actual "path")
-	std::copy(begin(), end(), std::back_inserter(bytesTarget));
+	if (!empty()) {
+		memcpy(target, data(), size());
+	}
+
+	return target + size();
 }
 
 void Terminal_Command_Block::Set_Module_ID(ketCube_moduleID_t id)
@@ -147,3 +261,34 @@ ketCube_moduleID_t Terminal_Command_Block::Get_Module_ID() const
 {
 	return mModuleID;
 }
+
+bool Terminal_Command_Block::push_back(uint8_t value)
+{
+	if (mLength >= Capacity) {
+		return false;
+	}
+
+	mData[mLength++] = value;
+
+	return true;
+}
+
+bool Terminal_Command_Block::resize(size_t size)
+{
+	if (size > Capacity) {
+		return false;
+	}
+
+	if (size > mLength) {
+		memset(&mData[mLength], 0, size - mLength);
+	}
+
+	mLength = static_cast<uint8_t>(size);
+
+	return true;
+}
+
+void Terminal_Command_Block::clear()
+{
+	mLength = 0;
+}
@@ -45,11 +45,16 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 #include "impl_bridge.h"
 
 struct ketCube_terminal_cmd_t;
 
+// maximum length of serialized packet; the largest LoRaWAN application payload of all regions
+constexpr size_t Terminal_Max_Packet_Length = 242;
+
 /*
  * Defined serializable options
  */
@@ -67,36 +72,96 @@ class ISerializable
 	public:
 		// serializes contents into byte buffer; respects serializable options given
 		virtual void Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options = {}) const = 0;
+		// retrieves exact serialized size; respects serializable options given
+		virtual size_t Get_Serialized_Size(const TSerializable_Options& options = {}) const = 0;
+		// serializes contents to preallocated memory of Get_Serialized_Size() bytes; returns pointer past the last written byte
+		virtual uint8_t* Serialize_To(uint8_t* target, const TSerializable_Options& options = {}) const = 0;
 };
 
 /*
- * Serializable terminal command block
+ * Serializable terminal command block; contents (command path and parameters) are stored inline
  */
-class Terminal_Command_Block : public std::vector<uint8_t>, public ISerializable
+class Terminal_Command_Block : public ISerializable
 {
+	public:
+		// maximum length of contents; the block has to fit into packet with header and module ID
+		static constexpr size_t Capacity = Terminal_Max_Packet_Length - sizeof(ketCube_remoteTerminal_packet_header_t) - sizeof(uint8_t);
+
 	protected:
 		// encapsulated module ID; the final physical length may vary according to serializer options
 		ketCube_moduleID_t mModuleID;
+		// length of contents
+		uint8_t mLength;
+		// contents
+		uint8_t mData[Capacity];
 
 	public:
+		Terminal_Command_Block();
+
 		virtual void Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options = {}) const override;
+		virtual size_t Get_Serialized_Size(const TSerializable_Options& options = {}) const override;
+		virtual uint8_t* Serialize_To(uint8_t* target, const TSerializable_Options& options = {}) const override;
 
 		// sets module ID, regardless of final length
 		void Set_Module_ID(ketCube_moduleID_t id);
 		// retrieves module ID (original)
 		ketCube_moduleID_t Get_Module_ID() const;
+
+		// appends byte to contents; returns false if the capacity is exhausted
+		bool push_back(uint8_t value);
+		// resizes contents (new bytes are zeroed); returns false if the size exceeds capacity
+		bool resize(size_t size);
+		// clears contents
+		void clear();
+
+		// retrieves length of contents
+		size_t size() const
+		{
+			return mLength;
+		}
+		// are the contents empty?
+		bool empty() const
+		{
+			return mLength == 0;
+		}
+		// retrieves contents
+		uint8_t* data()
+		{
+			return mData;
+		}
+		// retrieves contents
+		const uint8_t* data() const
+		{
+			return mData;
+		}
 };
 
 /*
- * Class providing additional packet-related routines
+ * Class providing additional packet-related routines; the whole packet is stored inline in single object,
+ * so it is copied without any allocation
  */
 class Terminal_Command_Buffer : public ISerializable
 {
+	public:
+		// capacity of block storage; every block is stored with 3 bytes of length and module ID, which is
+		// at most twice its serialized size, as the contents are never empty
+		static constexpr size_t Body_Capacity = 2 * Terminal_Max_Packet_Length;
+
 	private:
 		// packet header
 		ketCube_remoteTerminal_packet_header_t mHeader;
-		// all stored blocks (for all kinds of commands)
-		std::vector<Terminal_Command_Block> mBlocks;
+		// number of stored blocks
+		uint16_t mBlockCount;
+		// total length of contents of all blocks
+		uint16_t mContentsLength;
+		// used length of block storage
+		uint16_t mBodyLength;
+		// all stored blocks, each as [contents length, module ID LSB, module ID MSB, contents...]
+		uint8_t mBody[Body_Capacity];
+
+	protected:
+		// retrieves serializer options of blocks, that depend on header contents
+		TSerializable_Options Get_Block_Options() const;
 
 	public:
 		Terminal_Command_Buffer();
@@ -112,15 +177,24 @@ class Terminal_Command_Buffer : public ISerializable
 		// retrieves sequence number from header
 		uint8_t Get_Sequence_No() const;
 
+		// sets core API version the packet is encoded for
+		void Set_Core_Api_Version(uint16_t version);
+		// retrieves core API version the packet is encoded for
+		uint16_t Get_Core_Api_Version() const;
+
 		// sets 16bit moduleID flag
 		void Set_Flag_16bit_Module_ID(bool set = true);
 		// retrieves 16bit moduleID flag
 		bool Has_Flag_16bit_Module_Id() const;
 
 		virtual void Serialize(std::vector<uint8_t>& bytesTarget, const TSerializable_Options& options = {}) const override;
+		virtual size_t Get_Serialized_Size(const TSerializable_Options& options = {}) const override;
+		virtual uint8_t* Serialize_To(uint8_t* target, const TSerializable_Options& options = {}) const override;
 
-		// appends next terminal command block
-		void Append(const Terminal_Command_Block& block);
+		// appends next terminal command block; returns false if the packet would not fit into single frame
+		bool Append(const Terminal_Command_Block& block);
+		// retrieves number of stored blocks
+		size_t Get_Block_Count() const;
 		// resets the contents; reuses the instance
 		void Reset();
 };
@@ -0,0 +1,255 @@
+/**
+ * @file    trace_recorder.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of execution trace recorder
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <chrono>
+
+#include "trace_recorder.h"
+
+namespace {
+
+	/*
+	 * Single trace event
+	 */
+	struct Trace_Event
+	{
+		// event name (string literal)
+		const char* name;
+		// Chrome trace phase: 'X' complete, 'b'/'e' async begin/end
+		char phase;
+		// timestamp in microseconds
+		uint64_t ts;
+		// duration of complete event in microseconds
+		uint64_t dur;
+		// ID of async event, or argument of complete event
+		uint64_t id;
+	};
+
+	/*
+	 * Events of single thread; the lock is contended only when writing the trace out
+	 */
+	struct Trace_Buffer
+	{
+		// thread ID in trace
+		uint32_t tid;
+		// thread name; nullptr if not named
+		const char* name = nullptr;
+		// recorded events
+		std::vector<Trace_Event> events;
+		// guards events
+		std::mutex mtx;
+	};
+
+	// initial capacity of thread buffer
+	constexpr size_t Initial_Buffer_Capacity = 16 * 1024;
+
+	// buffers of all threads; they outlive their threads, so they could be written out at the end
+	std::list<std::unique_ptr<Trace_Buffer>> Buffers;
+	// guards list of buffers
+	std::mutex Buffers_Mtx;
+	// trace time origin
+	const std::chrono::steady_clock::time_point Origin = std::chrono::steady_clock::now();
+
+	// buffer of calling thread
+	thread_local Trace_Buffer* Thread_Buffer = nullptr;
+
+	Trace_Buffer& Get_Thread_Buffer()
+	{
+		if (Thread_Buffer == nullptr) {
+			std::unique_ptr<Trace_Buffer> buffer = std::make_unique<Trace_Buffer>();
+			buffer->events.reserve(Initial_Buffer_Capacity);
+
+			std::unique_lock<std::mutex> lck(Buffers_Mtx);
+
+			buffer->tid = static_cast<uint32_t>(Buffers.size() + 1);
+			Thread_Buffer = buffer.get();
+			Buffers.push_back(std::move(buffer));
+		}
+
+		return *Thread_Buffer;
+	}
+
+	void Record(const Trace_Event& evt)
+	{
+		Trace_Buffer& buffer = Get_Thread_Buffer();
+
+		std::unique_lock<std::mutex> lck(buffer.mtx);
+		buffer.events.push_back(evt);
+	}
+
+	void Write_Name(std::ostream& out, const char* name)
+	{
+		// names are literals from the code, so no escaping is needed
+		out << "\"" << name << "\"";
+	}
+}
+
+std::atomic<bool> Trace_Recorder::mEnabled{ false };
+
+void Trace_Recorder::Enable()
+{
+	mEnabled = true;
+}
+
+uint64_t Trace_Recorder::Now()
+{
+	// zero is reserved for "not recording"
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Origin).count()) + 1;
+}
+
+void Trace_Recorder::Complete(const char* name, uint64_t startUs, uint64_t id)
+{
+	if (!Is_Enabled()) {
+		return;
+	}
+
+	const uint64_t now = Now();
+	Record({ name, 'X', startUs, now - startUs, id });
+}
+
+void Trace_Recorder::Async_Begin(const char* name, uint64_t id)
+{
+	if (!Is_Enabled()) {
+		return;
+	}
+
+	Record({ name, 'b', Now(), 0, id });
+}
+
+void Trace_Recorder::Async_End(const char* name, uint64_t id)
+{
+	if (!Is_Enabled()) {
+		return;
+	}
+
+	Record({ name, 'e', Now(), 0, id });
+}
+
+void Trace_Recorder::Set_Thread_Name(const char* name)
+{
+	if (!Is_Enabled()) {
+		return;
+	}
+
+	Trace_Buffer& buffer = Get_Thread_Buffer();
+
+	std::unique_lock<std::mutex> lck(buffer.mtx);
+	buffer.name = name;
+}
+
+bool Trace_Recorder::Write(const std::string& path)
+{
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "Could not create trace file: " << path << std::endl;
+		return false;
+	}
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+	bool first = true;
+	auto separator = [&]() {
+		out << (first ? "" : ",\n");
+		first = false;
+	};
+
+	std::unique_lock<std::mutex> lck(Buffers_Mtx);
+
+	for (auto& bufferPtr : Buffers) {
+		Trace_Buffer& buffer = *bufferPtr;
+
+		std::unique_lock<std::mutex> blck(buffer.mtx);
+
+		if (buffer.name != nullptr) {
+			separator();
+			out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.tid << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+			Write_Name(out, buffer.name);
+			out << "}}";
+		}
+
+		for (const Trace_Event& evt : buffer.events) {
+			separator();
+
+			out << "{\"ph\":\"" << evt.phase << "\",\"pid\":1,\"tid\":" << buffer.tid << ",\"ts\":" << evt.ts << ",\"name\":";
+			Write_Name(out, evt.name);
+
+			if (evt.phase == 'X') {
+				out << ",\"dur\":" << evt.dur;
+				if (evt.id != 0) {
+					out << ",\"args\":{\"ticket\":" << evt.id << "}";
+				}
+			} else {
+				// async spans of the same command are grouped by ticket
+				out << ",\"cat\":\"command\",\"id\":" << evt.id;
+			}
+
+			out << "}";
+		}
+	}
+
+	out << std::endl << "]}" << std::endl;
+
+	return out.good();
+}
+
+Trace_Session::Trace_Session(const std::string& path)
+	: mPath(path)
+{
+	if (!mPath.empty()) {
+		Trace_Recorder::Enable();
+		Trace_Recorder::Set_Thread_Name("main");
+	}
+}
+
+Trace_Session::~Trace_Session()
+{
+	if (!mPath.empty()) {
+		Trace_Recorder::Write(mPath);
+	}
+}
@@ -0,0 +1,132 @@
+/**
+ * @file    trace_recorder.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains recorder of execution traces in Chrome trace format
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <atomic>
+
+/*
+ * Trace recorder - collects spans of command phases to per-thread buffers and writes them
+ * in Chrome trace JSON format (viewable in Perfetto or chrome://tracing); does nothing until enabled
+ */
+class Trace_Recorder
+{
+	private:
+		// is recording enabled?
+		static std::atomic<bool> mEnabled;
+
+	public:
+		// enables recording; must be called before any other thread starts
+		static void Enable();
+		// is recording enabled?
+		static bool Is_Enabled()
+		{
+			return mEnabled.load(std::memory_order_relaxed);
+		}
+
+		// retrieves trace timestamp in microseconds
+		static uint64_t Now();
+
+		// records span of calling thread from given start until now; name must be a string literal
+		static void Complete(const char* name, uint64_t startUs, uint64_t id = 0);
+		// records begin of asynchronous span with given ID (may end on another thread); name must be a string literal
+		static void Async_Begin(const char* name, uint64_t id);
+		// records end of asynchronous span with given ID
+		static void Async_End(const char* name, uint64_t id);
+		// names calling thread in trace; name must be a string literal
+		static void Set_Thread_Name(const char* name);
+
+		// writes all recorded events to file; returns false on failure
+		static bool Write(const std::string& path);
+};
+
+/*
+ * Scoped span - records span from construction to destruction, when recording is enabled
+ */
+class Trace_Span
+{
+	private:
+		// span name
+		const char* mName;
+		// span ID (e.g. ticket); 0 if none
+		uint64_t mId;
+		// start timestamp; 0 if recording is disabled
+		uint64_t mStart;
+
+	public:
+		Trace_Span(const char* name, uint64_t id = 0)
+			: mName(name), mId(id), mStart(Trace_Recorder::Is_Enabled() ? Trace_Recorder::Now() : 0)
+		{
+			//
+		}
+
+		~Trace_Span()
+		{
+			if (mStart != 0) {
+				Trace_Recorder::Complete(mName, mStart, mId);
+			}
+		}
+
+		Trace_Span(const Trace_Span&) = delete;
+		Trace_Span& operator=(const Trace_Span&) = delete;
+};
+
+/*
+ * Trace session - enables recording when given non-empty path, writes the trace out on destruction
+ */
+class Trace_Session
+{
+	private:
+		// trace output file
+		std::string mPath;
+
+	public:
+		Trace_Session(const std::string& path);
+		~Trace_Session();
+
+		Trace_Session(const Trace_Session&) = delete;
+		Trace_Session& operator=(const Trace_Session&) = delete;
+};
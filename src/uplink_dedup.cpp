@@ -0,0 +1,158 @@
+/**
+ * @file    uplink_dedup.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains implementation of time-windowed uplink deduplication filter
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include "uplink_dedup.h"
+
+#include <chrono>
+
+// FNV-1a parameters
+static constexpr uint64_t Fnv_Offset = 14695981039346656037ULL;
+static constexpr uint64_t Fnv_Prime = 1099511628211ULL;
+
+// fingerprint domains, so message and frame fingerprints never collide by construction
+static constexpr uint8_t Domain_Message = 'M';
+static constexpr uint8_t Domain_Frame = 'F';
+
+static uint64_t Hash_Bytes(uint64_t hash, const uint8_t* data, size_t length)
+{
+	for (size_t i = 0; i < length; i++) {
+		hash ^= data[i];
+		hash *= Fnv_Prime;
+	}
+
+	return hash;
+}
+
+// final mixing, so the low bits used for bucket selection depend on all the input
+static uint64_t Finish_Fingerprint(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	// 0 marks empty entry
+	return (hash == 0) ? 1 : hash;
+}
+
+static uint64_t Steady_Now_Ms()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Uplink_Dedup::Uplink_Dedup()
+	: mBucketMask(0), mWindowMs(0)
+{
+	//
+}
+
+void Uplink_Dedup::Configure(uint64_t windowMs, size_t capacity)
+{
+	size_t buckets = 1;
+	while (buckets * Ways < capacity) {
+		buckets <<= 1;
+	}
+
+	mEntries.assign(buckets * Ways, Entry{ 0, 0 });
+	mBucketMask = buckets - 1;
+	mWindowMs = windowMs;
+}
+
+bool Uplink_Dedup::Is_Enabled() const
+{
+	return mWindowMs != 0 && !mEntries.empty();
+}
+
+bool Uplink_Dedup::Is_Duplicate(uint64_t fingerprint)
+{
+	if (!Is_Enabled()) {
+		return false;
+	}
+
+	const size_t bucket = static_cast<size_t>(fingerprint) & mBucketMask;
+	Entry* entries = &mEntries[bucket * Ways];
+	const uint64_t now = Steady_Now_Ms();
+
+	std::unique_lock<std::mutex> lck(mLocks[bucket % Lock_Count]);
+
+	Entry* victim = &entries[0];
+
+	for (size_t i = 0; i < Ways; i++) {
+		if (entries[i].fingerprint == fingerprint && now - entries[i].timeMs <= mWindowMs) {
+			return true;
+		}
+
+		// empty entries have zero time, so they are taken first
+		if (entries[i].timeMs < victim->timeMs) {
+			victim = &entries[i];
+		}
+	}
+
+	victim->fingerprint = fingerprint;
+	victim->timeMs = now;
+
+	return false;
+}
+
+uint64_t Uplink_Dedup::Message_Fingerprint(const std::string& node, const std::string& message)
+{
+	uint64_t hash = Hash_Bytes(Fnv_Offset, &Domain_Message, 1);
+	hash = Hash_Bytes(hash, reinterpret_cast<const uint8_t*>(node.data()), node.length() + 1);
+	hash = Hash_Bytes(hash, reinterpret_cast<const uint8_t*>(message.data()), message.length());
+
+	return Finish_Fingerprint(hash);
+}
+
+uint64_t Uplink_Dedup::Frame_Fingerprint(const std::string& node, uint32_t fCnt, const std::vector<uint8_t>& frame)
+{
+	const uint8_t fCntBytes[4] = {
+		static_cast<uint8_t>(fCnt), static_cast<uint8_t>(fCnt >> 8), static_cast<uint8_t>(fCnt >> 16), static_cast<uint8_t>(fCnt >> 24)
+	};
+
+	uint64_t hash = Hash_Bytes(Fnv_Offset, &Domain_Frame, 1);
+	hash = Hash_Bytes(hash, reinterpret_cast<const uint8_t*>(node.data()), node.length() + 1);
+	hash = Hash_Bytes(hash, fCntBytes, sizeof(fCntBytes));
+	hash = Hash_Bytes(hash, frame.data(), frame.size());
+
+	return Finish_Fingerprint(hash);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file    uplink_dedup.h
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains time-windowed uplink deduplication filter
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <mutex>
+
+/*
+ * Filter of uplinks seen more than once within time window (heard by several gateways, or received through overlapping
+ * subscriptions); set-associative table of fingerprints, so both memory and check time are bounded
+ */
+class Uplink_Dedup final
+{
+	public:
+		// number of fingerprints in one bucket; the oldest one is replaced when the bucket is full
+		static constexpr size_t Ways = 4;
+		// number of locks guarding buckets
+		static constexpr size_t Lock_Count = 16;
+
+	private:
+		/*
+		 * Remembered uplink
+		 */
+		struct Entry
+		{
+			// uplink fingerprint; 0 for empty entry
+			uint64_t fingerprint;
+			// when the uplink was last seen (steady clock milliseconds)
+			uint64_t timeMs;
+		};
+
+		// buckets of Ways entries each
+		std::vector<Entry> mEntries;
+		// bucket count - 1
+		size_t mBucketMask;
+		// duplicates are dropped within this time; 0 = filter disabled
+		uint64_t mWindowMs;
+		// locks guarding buckets, bucket index modulo Lock_Count
+		std::mutex mLocks[Lock_Count];
+
+	public:
+		Uplink_Dedup();
+
+		// sets time window (0 disables the filter) and number of remembered uplinks (rounded up to power of two buckets)
+		void Configure(uint64_t windowMs, size_t capacity);
+		// is the filter enabled?
+		bool Is_Enabled() const;
+
+		// checks, if the uplink with given fingerprint was seen within the window; remembers it otherwise
+		bool Is_Duplicate(uint64_t fingerprint);
+
+		// fingerprint of raw message of given node - catches byte-identical copies before decoding
+		static uint64_t Message_Fingerprint(const std::string& node, const std::string& message);
+		// fingerprint of decoded frame of given node - catches copies differing in metadata (e.g. gateway)
+		static uint64_t Frame_Fingerprint(const std::string& node, uint32_t fCnt, const std::vector<uint8_t>& frame);
+};
@@ -0,0 +1,188 @@
+/**
+ * @file    response_parser_fuzz.cpp
+ * @author  Martin Ubl
+ * @version 0.1
+ * @date    2026-10-19
+ * @brief   This file contains fuzz harness of remote terminal response parser
+ *
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2026 University of West Bohemia in Pilsen
+ * All rights reserved.</center></h2>
+ *
+ * Developed by:
+ * The SmartCampus Team
+ * Department of Technologies and Measurement
+ * www.smartcampus.cz | www.zcu.cz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal with the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *      this list of conditions and the following disclaimers.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright notice,
+ *      this list of conditions and the following disclaimers in the documentation
+ *      and/or other materials provided with the distribution.
+ *
+ *    - Neither the names of The SmartCampus Team, Department of Technologies and Measurement
+ *      and Faculty of Electrical Engineering University of West Bohemia in Pilsen,
+ *      nor the names of its contributors may be used to endorse or promote products
+ *      derived from this Software without specific prior written permission.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS WITH THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "response_parser.h"
+#include "command_schema.h"
+#include "terminal.h"
+
+// most commands a batch response is parsed for
+static const size_t Max_Batch_Responses = 3;
+
+// output types every parsed response is formatted as
+static const ketCube_terminal_paramSetType_t Output_Types[] = {
+	KETCUBE_TERMINAL_PARAMS_NONE,
+	KETCUBE_TERMINAL_PARAMS_BOOLEAN,
+	KETCUBE_TERMINAL_PARAMS_STRING,
+	KETCUBE_TERMINAL_PARAMS_INT32,
+	KETCUBE_TERMINAL_PARAMS_UINT32,
+	KETCUBE_TERMINAL_PARAMS_BYTE,
+	KETCUBE_TERMINAL_PARAMS_INT32_PAIR,
+	KETCUBE_TERMINAL_PARAMS_BYTE_ARRAY,
+	KETCUBE_TERMINAL_PARAMS_MODULEID,
+};
+
+// aborts, when the response value does not lie within the frame
+static void Check_Within(const Command_Response_View& response, const uint8_t* frame, size_t frameLen)
+{
+	if (response.value.length == 0) {
+		return;
+	}
+
+	if (response.value.data < frame || response.value.data + response.value.length > frame + frameLen) {
+		std::cerr << "Response value out of frame bounds" << std::endl;
+		abort();
+	}
+}
+
+// formats response as every output type; sanitizers catch any read outside the value
+static void Format_All(const Command_Response_View& response)
+{
+	const Command_Schema& schema = Command_Schema::Built_In();
+	ketCube_terminal_cmd_t command;
+	std::string out, error;
+
+	memset(&command, 0, sizeof(command));
+	command.cmd = const_cast<char*>("fuzz");
+
+	for (ketCube_terminal_paramSetType_t type : Output_Types) {
+		command.outputSetType = type;
+		out.clear();
+		error.clear();
+		Response_Parser::Format_Value(response, &command, schema, out, error);
+	}
+}
+
+// runs both parsers over given frame
+static void Fuzz_Frame(const uint8_t* frame, size_t frameLen)
+{
+	std::vector<Command_Response_View> responses;
+	Command_Response_View response;
+	std::string error;
+
+	if (Response_Parser::Parse_Batch(Byte_Span(frame, frameLen), Max_Batch_Responses, responses, error)) {
+		if (responses.size() > Max_Batch_Responses) {
+			std::cerr << "Batch yielded " << responses.size() << " responses" << std::endl;
+			abort();
+		}
+
+		for (const Command_Response_View& batchResponse : responses) {
+			Check_Within(batchResponse, frame, frameLen);
+			Format_All(batchResponse);
+		}
+	} else if (!responses.empty()) {
+		std::cerr << "Malformed batch yielded responses" << std::endl;
+		abort();
+	}
+
+	if (Response_Parser::Parse_Single(Byte_Span(frame, frameLen), response, error)) {
+		Check_Within(response, frame, frameLen);
+		Format_All(response);
+	}
+}
+
+// libFuzzer entry point
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	Fuzz_Frame(data, size);
+
+	return 0;
+}
+
+#ifndef KETCUBE_LIBFUZZER
+
+// builds batch response with mostly valid structure, so the parser gets past the header and length checks
+static void Build_Batch(std::mt19937& rng, std::vector<uint8_t>& frame)
+{
+	frame.assign(Terminal_Base::Response_Header_Length, 0);
+	frame[0] = KETCUBE_TERMINAL_OPCODE_BATCH;
+
+	const size_t responseCnt = rng() % (Max_Batch_Responses + 2);
+
+	for (size_t i = 0; i < responseCnt; i++) {
+		const size_t valueLen = rng() % 40;
+
+		// length is sometimes off, so it points past the value (or the frame)
+		frame.push_back(static_cast<uint8_t>(valueLen + ((rng() % 3 == 0) ? rng() % 3 : 0)));
+
+		for (size_t j = 0; j < valueLen; j++) {
+			frame.push_back((rng() % 4 != 0) ? 0 : static_cast<uint8_t>(rng()));
+		}
+	}
+}
+
+// standalone run - random and structured frames from fixed seed
+int main(int argc, char** argv)
+{
+	const unsigned long iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+	const unsigned long seed = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+	std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+	std::vector<uint8_t> frame;
+
+	for (unsigned long i = 0; i < iterations; i++) {
+		if (i % 2 == 0) {
+			frame.resize(rng() % 80);
+			for (uint8_t& byte : frame) {
+				byte = static_cast<uint8_t>(rng());
+			}
+		} else {
+			Build_Batch(rng, frame);
+		}
+
+		Fuzz_Frame(frame.data(), frame.size());
+	}
+
+	std::cout << iterations << " frames parsed" << std::endl;
+
+	return 0;
+}
+
+#endif